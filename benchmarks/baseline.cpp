@@ -0,0 +1,106 @@
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include "baseline.hpp"
+
+namespace XLang::Bench {
+    static constexpr int baseline_version = 1;
+
+    void write_baseline(const std::string& path, const BenchMetrics& metrics) {
+        std::string json_text = std::format("{{\n    \"version\": {},\n    \"metrics\": {{\n", baseline_version);
+        auto metrics_left = metrics.size();
+
+        for (const auto& [metric_name, metric_value] : metrics) {
+            json_text += std::format("        \"{}\": {:.1f}{}\n", metric_name, metric_value, (--metrics_left > 0) ? "," : "");
+        }
+
+        json_text += "    }\n}\n";
+
+        std::ofstream writer {path};
+
+        if (!(writer << json_text)) {
+            throw std::runtime_error {std::format("Cannot write baseline '{}'.", path)};
+        }
+    }
+
+    BenchMetrics read_baseline(const std::string& path) {
+        std::ifstream reader {path};
+
+        if (!reader) {
+            throw std::runtime_error {std::format("Cannot open baseline '{}'.", path)};
+        }
+
+        const std::string json_text {std::istreambuf_iterator<char> {reader}, std::istreambuf_iterator<char> {}};
+        const std::string_view json_sv {json_text};
+        auto malformed = [&path] {
+            return std::runtime_error {std::format("Malformed baseline '{}'.", path)};
+        };
+
+        auto json_pos = json_sv.find("\"metrics\"");
+        json_pos = (json_pos != std::string_view::npos) ? json_sv.find('{', json_pos) : json_pos;
+
+        if (json_pos == std::string_view::npos) {
+            throw malformed();
+        }
+
+        auto skip_spaces = [&json_sv, &json_pos] {
+            while (json_pos < json_sv.size() && std::isspace(static_cast<unsigned char>(json_sv[json_pos]))) {
+                ++json_pos;
+            }
+        };
+
+        BenchMetrics metrics;
+        ++json_pos;
+
+        for (;;) {
+            skip_spaces();
+
+            if (json_pos >= json_sv.size()) {
+                throw malformed();
+            }
+
+            if (json_sv[json_pos] == '}') {
+                break;
+            }
+
+            const auto name_end = (json_sv[json_pos] == '"') ? json_sv.find('"', json_pos + 1) : std::string_view::npos;
+
+            if (name_end == std::string_view::npos) {
+                throw malformed();
+            }
+
+            const auto metric_name = json_sv.substr(json_pos + 1, name_end - json_pos - 1);
+            json_pos = name_end + 1;
+            skip_spaces();
+
+            if (json_pos >= json_sv.size() || json_sv[json_pos] != ':') {
+                throw malformed();
+            }
+
+            ++json_pos;
+            skip_spaces();
+
+            double metric_value = 0.0;
+            const auto [value_end, value_error] = std::from_chars(json_sv.data() + json_pos, json_sv.data() + json_sv.size(), metric_value);
+
+            if (value_error != std::errc {}) {
+                throw malformed();
+            }
+
+            metrics.emplace(metric_name, metric_value);
+            json_pos = static_cast<std::size_t>(value_end - json_sv.data());
+            skip_spaces();
+
+            if (json_pos < json_sv.size() && json_sv[json_pos] == ',') {
+                ++json_pos;
+            }
+        }
+
+        return metrics;
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace XLang::Bench {
+    /// @brief Higher-is-better benchmark metrics by name, e.g. `fib.vm_stack.instructions_per_sec`.
+    using BenchMetrics = std::map<std::string, double>;
+
+    /**
+     * @brief Writes metrics as a baseline file: a JSON object with a `version` and a flat `metrics` object of names to numbers.
+     * @note Throws `std::runtime_error` when the file cannot be written.
+     */
+    void write_baseline(const std::string& path, const BenchMetrics& metrics);
+
+    /**
+     * @brief Reads back the `metrics` of a baseline file from `write_baseline`. Only that flat layout is understood, not JSON in general.
+     * @note Throws `std::runtime_error` on unreadable or malformed files.
+     */
+    [[nodiscard]] BenchMetrics read_baseline(const std::string& path);
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <utility>
+#include "program_gen.hpp"
+
+namespace XLang::Bench {
+    static constexpr std::string_view param_names[] = {"lhs", "rhs"};
+    static constexpr std::string_view operator_texts[] = {" + ", " - "};
+
+    ProgramGenerator::ProgramGenerator(const GenConfig& config)
+    : m_config {
+        .function_count = std::max(config.function_count, 1),
+        .nesting_depth = std::max(config.nesting_depth, 0),
+        .expr_size = std::max(config.expr_size, 1),
+        .identifier_count = std::max(config.identifier_count, 1),
+        .seed = config.seed
+    }, m_rng {config.seed}, m_out {} {}
+
+    std::string ProgramGenerator::operator()() {
+        m_out.clear();
+        m_rng.seed(m_config.seed);
+
+        for (auto func_idx = 0; func_idx < m_config.function_count; ++func_idx) {
+            emit_function(func_idx);
+        }
+
+        emit_main();
+
+        return std::move(m_out);
+    }
+
+    /// @note Identifiers cannot hold digits yet, so indices are spelled in base 26 with letters instead.
+    std::string ProgramGenerator::letter_name(std::string_view prefix, int index) {
+        std::string letters;
+
+        do {
+            letters += static_cast<char>('a' + index % 26);
+            index /= 26;
+        } while (index > 0);
+
+        std::ranges::reverse(letters);
+
+        return std::format("{}{}", prefix, letters);
+    }
+
+    /// @note Plain modulo of the raw engine output keeps programs identical across standard libraries, unlike the distributions.
+    int ProgramGenerator::pick(int bound) {
+        return static_cast<int>(m_rng() % static_cast<std::uint32_t>(bound));
+    }
+
+    void ProgramGenerator::emit_expr(int visible_locals) {
+        for (auto operand_idx = 0; operand_idx < m_config.expr_size; ++operand_idx) {
+            if (operand_idx > 0) {
+                m_out += operator_texts[pick(static_cast<int>(std::size(operator_texts)))];
+            }
+
+            if (operand_idx == 0 && visible_locals > 0) {
+                m_out += letter_name("v_", pick(visible_locals));
+                continue;
+            }
+
+            switch (pick(3)) {
+                case 0:
+                    m_out += param_names[pick(static_cast<int>(std::size(param_names)))];
+                    break;
+                case 1:
+                    m_out += std::format("{}", 1 + pick(9));
+                    break;
+                default:
+                    m_out += std::format("({} * {})", param_names[pick(static_cast<int>(std::size(param_names)))], 1 + pick(9));
+                    break;
+            }
+        }
+    }
+
+    void ProgramGenerator::emit_nested_block(int depth, int indent) {
+        const std::string pad (static_cast<std::size_t>(indent) * 4, ' ');
+        const auto locals_n = m_config.identifier_count;
+
+        m_out += std::format("{}if ({} {} {}) {{\n", pad, letter_name("v_", pick(locals_n)), (pick(2) == 0) ? "<" : ">", pick(20));
+
+        /// NOTE: only truthy branches nest further, so the block count grows linearly with the depth.
+        for (const auto& [branch_text, nests] : {std::pair {"} else {\n", true}, std::pair {"}\n", false}}) {
+            m_out += std::format("{}    {} = ", pad, letter_name("v_", pick(locals_n)));
+            emit_expr(0);
+            m_out += ";\n";
+
+            if (nests && depth > 1) {
+                emit_nested_block(depth - 1, indent + 1);
+            }
+
+            m_out += std::format("{}{}", pad, branch_text);
+        }
+    }
+
+    void ProgramGenerator::emit_function(int func_idx) {
+        const auto locals_n = m_config.identifier_count;
+
+        m_out += std::format("func {}(lhs: int, rhs: int,): int {{\n", letter_name("fn_", func_idx));
+
+        for (auto local_idx = 0; local_idx < locals_n; ++local_idx) {
+            m_out += std::format("    let {}: int = ", letter_name("v_", local_idx));
+            emit_expr(local_idx);
+            m_out += ";\n";
+        }
+
+        /// NOTE: each function calls one earlier function with bounded arguments, so call chains stay logarithmic in length.
+        if (func_idx > 0) {
+            m_out += std::format("    {} = {} + {}(lhs, {},);\n", letter_name("v_", 0), letter_name("v_", 0), letter_name("fn_", (func_idx - 1) / 2), 1 + pick(9));
+        }
+
+        if (m_config.nesting_depth > 0) {
+            emit_nested_block(m_config.nesting_depth, 1);
+        }
+
+        m_out += std::format("    return {};\n}}\n\n", letter_name("v_", locals_n - 1));
+    }
+
+    void ProgramGenerator::emit_main() {
+        m_out += "func main(): int {\n    let total: int = 0;\n";
+
+        for (auto func_idx = 0; func_idx < m_config.function_count; ++func_idx) {
+            m_out += std::format("    total = {}({}, {},);\n", letter_name("fn_", func_idx), pick(7), pick(7));
+        }
+
+        m_out += "    return 0;\n}\n";
+    }
+}
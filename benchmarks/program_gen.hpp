@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace XLang::Bench {
+    struct GenConfig {
+        int function_count;
+        /// @note Levels of nested `if-else` blocks in each function body.
+        int nesting_depth;
+        /// @note Operands per generated expression.
+        int expr_size;
+        /// @note Local variables declared per function.
+        int identifier_count;
+        std::uint32_t seed;
+    };
+
+    inline constexpr GenConfig default_gen_config {
+        .function_count = 64,
+        .nesting_depth = 1,
+        .expr_size = 6,
+        .identifier_count = 8,
+        .seed = 42
+    };
+
+    /**
+     * @brief Emits a synthetic Xplice program for front-end scaling runs: `function_count` functions of integer locals and `if-else` blocks, called one by one from `main`. Output is deterministic per config.
+     * @note Only constructs the compiler currently accepts are generated: no `while` loops, and identifiers without digits. Every value stays small enough to never overflow, and `main` always returns 0. Programs with `nesting_depth > 1` compile, but nested `if-else` blocks still get bad jump targets from `EmitCodePass`, so the VM rejects them at load.
+     */
+    class ProgramGenerator {
+    public:
+        explicit ProgramGenerator(const GenConfig& config);
+
+        [[nodiscard]] std::string operator()();
+
+    private:
+        [[nodiscard]] static std::string letter_name(std::string_view prefix, int index);
+
+        [[nodiscard]] int pick(int bound);
+
+        /// @note Draws operands from the parameters, small literals, and at most one local below `visible_locals`, so values only grow linearly along a function.
+        void emit_expr(int visible_locals);
+        void emit_nested_block(int depth, int indent);
+        void emit_function(int func_idx);
+        void emit_main();
+
+        GenConfig m_config;
+        std::mt19937 m_rng;
+        std::string m_out;
+    };
+}
@@ -0,0 +1,705 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "frontend/files.hpp"
+#include "frontend/lexer.hpp"
+#include "frontend/parser.hpp"
+#include "semantics/analysis.hpp"
+#include "codegen/graph_pass.hpp"
+#include "codegen/emit_pass.hpp"
+#include "vm/chunk.hpp"
+#include "vm/vm.hpp"
+#include "baseline.hpp"
+#include "program_gen.hpp"
+
+using namespace XLang;
+
+/// @brief Heap traffic seen by the replaced global `operator new` below, only counted inside timed runs.
+struct AllocCounters {
+    std::size_t count;
+    std::size_t bytes;
+};
+
+/// @note Every block carries its size in a header, so live and peak heap bytes are tracked at all times.
+constexpr std::size_t alloc_header_size = alignof(std::max_align_t);
+
+constinit bool g_count_allocs = false;
+constinit AllocCounters g_alloc_counters {0, 0};
+constinit std::size_t g_live_heap_bytes = 0;
+constinit std::size_t g_peak_heap_bytes = 0;
+
+void* operator new(std::size_t size) {
+    if (g_count_allocs) {
+        ++g_alloc_counters.count;
+        g_alloc_counters.bytes += size;
+    }
+
+    for (;;) {
+        if (void* block = std::malloc(alloc_header_size + size); block != nullptr) {
+            *static_cast<std::size_t*>(block) = size;
+            g_live_heap_bytes += size;
+            g_peak_heap_bytes = std::max(g_peak_heap_bytes, g_live_heap_bytes);
+
+            return static_cast<unsigned char*>(block) + alloc_header_size;
+        }
+
+        if (auto new_handler = std::get_new_handler(); new_handler != nullptr) {
+            new_handler();
+        } else {
+            throw std::bad_alloc {};
+        }
+    }
+}
+
+/// NOTE: GCC sees these inlined next to the `new` above and mistakes `free` for a mismatched deallocation.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* block) noexcept {
+    if (block == nullptr) {
+        return;
+    }
+
+    void* header = static_cast<unsigned char*>(block) - alloc_header_size;
+    g_live_heap_bytes -= *static_cast<std::size_t*>(header);
+    std::free(header);
+}
+
+void operator delete(void* block, [[maybe_unused]] std::size_t size) noexcept {
+    ::operator delete(block);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+struct BenchOptions {
+    std::filesystem::path workload_dir;
+    std::filesystem::path analog_dir;
+    std::string python_path;
+    std::string filter;
+    std::chrono::milliseconds min_time;
+    /// @note Largest generated function count of a `--scaling` run, or 0 to run the workloads instead.
+    int scaling_max_functions;
+    std::string csv_path;
+    std::string json_path;
+    std::string check_path;
+    /// @note How far in percent a metric may fall below its baseline before `--check` fails.
+    double threshold_percent;
+};
+
+/// @brief One stage of one workload. `instructions_per_sec` is only set for VM runs. Throughputs use `best_ns`, the fastest run, since host noise only ever slows runs down.
+struct BenchResult {
+    std::string workload;
+    std::string_view stage;
+    std::size_t iterations;
+    double ns_per_op;
+    double best_ns;
+    double allocs_per_op;
+    double bytes_per_op;
+    double instructions_per_sec;
+};
+
+/// @brief Everything the later stages consume, compiled once per workload so each stage can be timed alone.
+struct CompiledWorkload {
+    std::string source;
+    std::vector<Syntax::StmtPtr> ast;
+    Semantics::SemanticResult sema_result;
+    Codegen::IRStore ir;
+    VM::XpliceProgram program;
+};
+
+constexpr std::size_t min_iterations = 3;
+
+/**
+ * @brief Times `run` over fresh state from `setup` until both `min_iterations` and the minimum time are reached. Only `run` is timed and counted, and its result is destroyed outside the timed region.
+ */
+template <typename Setup, typename Run>
+[[nodiscard]] BenchResult time_stage(const BenchOptions& options, std::string_view workload, std::string_view stage, Setup&& setup, Run&& run) {
+    std::chrono::nanoseconds time_spent {0};
+    auto best_time = std::chrono::nanoseconds::max();
+    std::size_t iterations = 0;
+    const auto allocs_before = g_alloc_counters;
+
+    while (iterations < min_iterations || time_spent < options.min_time) {
+        auto stage_state = setup();
+
+        g_count_allocs = true;
+        const auto time_before = std::chrono::steady_clock::now();
+        [[maybe_unused]] const auto stage_result = run(stage_state);
+        const auto time_after = std::chrono::steady_clock::now();
+        g_count_allocs = false;
+
+        time_spent += time_after - time_before;
+        best_time = std::min(best_time, std::chrono::nanoseconds {time_after - time_before});
+        ++iterations;
+    }
+
+    const auto iterations_f = static_cast<double>(iterations);
+
+    return {
+        .workload = std::string {workload},
+        .stage = stage,
+        .iterations = iterations,
+        .ns_per_op = static_cast<double>(time_spent.count()) / iterations_f,
+        .best_ns = static_cast<double>(best_time.count()),
+        .allocs_per_op = static_cast<double>(g_alloc_counters.count - allocs_before.count) / iterations_f,
+        .bytes_per_op = static_cast<double>(g_alloc_counters.bytes - allocs_before.bytes) / iterations_f,
+        .instructions_per_sec = 0.0
+    };
+}
+
+[[nodiscard]] CompiledWorkload compile_workload(const std::filesystem::path& workload_path) {
+    CompiledWorkload compiled {
+        .source = Frontend::read_file(workload_path.string().c_str()),
+        .ast = {},
+        .sema_result = {},
+        .ir = {},
+        .program = {}
+    };
+
+    Frontend::Parser parser {compiled.source};
+    auto [ast, parse_errors] = parser();
+
+    if (!parse_errors.empty()) {
+        throw std::logic_error {std::format("Workload '{}' has parse errors.", workload_path.string())};
+    }
+
+    compiled.ast = std::move(ast);
+
+    Semantics::SemanticsPass sema {compiled.source};
+    compiled.sema_result = sema(compiled.ast);
+
+    if (!compiled.sema_result.errors.empty()) {
+        throw std::logic_error {std::format("Workload '{}' has semantic errors.", workload_path.string())};
+    }
+
+    Codegen::GraphPass ir_emitter {compiled.source, &compiled.sema_result.native_hints, &compiled.sema_result.operand_hints};
+    compiled.ir = ir_emitter.process(compiled.ast);
+
+    const auto& [ir_constants, ir_stack_depths, ir_func_names, ir_graphs, ir_main_id] = compiled.ir;
+    Codegen::EmitCodePass bytecode_emitter;
+    compiled.program = std::move(*bytecode_emitter.process_full_ir(ir_constants, ir_stack_depths, ir_func_names, *ir_graphs, ir_main_id));
+
+    return compiled;
+}
+
+/// @note Counts the instructions one run executes with the opcode profiler, so timed runs can be turned into instructions per second without paying for it.
+[[nodiscard]] std::uint64_t count_executed_instructions(const VM::XpliceProgram& program, VM::EngineKind engine_kind) {
+    VM::VM engine {program, engine_kind};
+    engine.enable_profiling();
+
+    if (engine.run() != VM::Errcode::xerr_normal) {
+        throw std::runtime_error {"Workload failed its own result check."};
+    }
+
+    const auto& op_counts = engine.profiler()->op_counts();
+
+    return std::accumulate(op_counts.begin(), op_counts.end(), std::uint64_t {0});
+}
+
+void bench_workload(const BenchOptions& options, const std::filesystem::path& workload_path, std::vector<BenchResult>& results) {
+    const auto workload = workload_path.stem().string();
+    const auto compiled = compile_workload(workload_path);
+    const std::string_view source_sv {compiled.source};
+    const auto& [ir_constants, ir_stack_depths, ir_func_names, ir_graphs, ir_main_id] = compiled.ir;
+    auto no_state = [] { return 0; };
+
+    results.push_back(time_stage(options, workload, "lex", no_state, [source_sv](int) {
+        Frontend::Lexer lexer {source_sv};
+        std::size_t token_count = 0;
+
+        while (lexer().tag != Frontend::LexTag::eof) {
+            ++token_count;
+        }
+
+        return token_count;
+    }));
+
+    results.push_back(time_stage(options, workload, "parse", no_state, [source_sv](int) {
+        Frontend::Parser parser {source_sv};
+
+        return parser();
+    }));
+
+    results.push_back(time_stage(options, workload, "semantics", no_state, [&compiled, source_sv](int) {
+        Semantics::SemanticsPass sema {source_sv};
+
+        return sema(compiled.ast);
+    }));
+
+    results.push_back(time_stage(options, workload, "graph", no_state, [&compiled, source_sv](int) {
+        Codegen::GraphPass ir_emitter {source_sv, &compiled.sema_result.native_hints, &compiled.sema_result.operand_hints};
+
+        return ir_emitter.process(compiled.ast);
+    }));
+
+    results.push_back(time_stage(options, workload, "emit", no_state, [&](int) {
+        Codegen::EmitCodePass bytecode_emitter;
+
+        return bytecode_emitter.process_full_ir(ir_constants, ir_stack_depths, ir_func_names, *ir_graphs, ir_main_id);
+    }));
+
+    for (const auto& [engine_kind, stage_name] : {std::pair {VM::EngineKind::xek_stack, "vm_stack"}, std::pair {VM::EngineKind::xek_register, "vm_register"}}) {
+        const auto instruction_count = count_executed_instructions(compiled.program, engine_kind);
+
+        auto vm_result = time_stage(options, workload, stage_name, [&compiled, engine_kind] {
+            return VM::VM {compiled.program, engine_kind};
+        }, [](VM::VM& engine) {
+            return engine.run();
+        });
+
+        vm_result.instructions_per_sec = static_cast<double>(instruction_count) / (vm_result.best_ns * 1e-9);
+        results.push_back(std::move(vm_result));
+    }
+}
+
+/// @note Best wall time of a few runs of `python_path script_path` in seconds, or nothing when a run fails.
+[[nodiscard]] std::optional<double> time_python_run(const std::string& python_path, const std::string& script_args) {
+    constexpr int python_runs_n = 3;
+    const auto command = std::format("\"{}\" {}", python_path, script_args);
+    std::optional<double> best_seconds;
+
+    for (int run_idx = 0; run_idx < python_runs_n; ++run_idx) {
+        const auto time_before = std::chrono::steady_clock::now();
+        const auto run_status = std::system(command.c_str());
+        const auto time_after = std::chrono::steady_clock::now();
+
+        if (run_status != 0) {
+            return {};
+        }
+
+        const auto seconds = std::chrono::duration<double> {time_after - time_before}.count();
+        best_seconds = std::min(best_seconds.value_or(seconds), seconds);
+    }
+
+    return best_seconds;
+}
+
+/// @brief Prints Python's time for each workload's analog next to xplice's compile plus stack-VM time. Python's own startup time is measured and subtracted.
+void compare_with_python(const BenchOptions& options, const std::vector<std::filesystem::path>& workload_paths, const std::vector<BenchResult>& results) {
+    if (options.python_path.empty()) {
+        std::print("\nSkipping Python comparison: pass --python <path> to enable it.\n");
+        return;
+    }
+
+    const auto startup_seconds = time_python_run(options.python_path, "-c \"pass\"");
+
+    if (!startup_seconds) {
+        std::print("\nSkipping Python comparison: '{}' did not run.\n", options.python_path);
+        return;
+    }
+
+    std::print("\n{:<16}{:>14}{:>14}{:>10}\n", "workload", "python ms", "xplice ms", "speedup");
+
+    for (const auto& workload_path : workload_paths) {
+        const auto workload = workload_path.stem().string();
+        const auto analog_path = options.analog_dir / (workload + ".py");
+
+        if (!std::filesystem::exists(analog_path)) {
+            continue;
+        }
+
+        const auto python_seconds = time_python_run(options.python_path, std::format("\"{}\"", analog_path.string()));
+
+        if (!python_seconds) {
+            std::print("{:<16}{:>14}\n", workload, "failed");
+            continue;
+        }
+
+        /// NOTE: `lex` is left out, as `parse` already drives the lexer.
+        double xplice_ns = 0.0;
+
+        for (const auto& result : results) {
+            if (result.workload == workload && result.stage != "lex" && result.stage != "vm_register") {
+                xplice_ns += result.ns_per_op;
+            }
+        }
+
+        const auto python_ms = std::max(*python_seconds - *startup_seconds, 0.0) * 1e3;
+        const auto xplice_ms = xplice_ns * 1e-6;
+
+        std::print("{:<16}{:>14.2f}{:>14.2f}{:>9.1f}x\n", workload, python_ms, xplice_ms, (xplice_ms > 0.0) ? python_ms / xplice_ms : 0.0);
+    }
+}
+
+/// @brief One program size of a `--scaling` run. Phase times are the best of `scaling_repeats` compiles, and the peak heap is what one compile holds on top of the source text.
+struct ScalingRow {
+    int function_count;
+    std::size_t source_lines;
+    std::size_t source_bytes;
+    std::array<double, 5> phase_ms;
+    std::size_t peak_heap_bytes;
+};
+
+constexpr std::array<std::string_view, 5> scaling_phase_names {"lex", "parse", "semantics", "graph", "emit"};
+constexpr int scaling_repeats = 3;
+constexpr int scaling_min_functions = 16;
+
+template <typename Phase>
+[[nodiscard]] auto time_phase(double& best_ms, Phase&& phase) {
+    const auto time_before = std::chrono::steady_clock::now();
+    auto phase_result = phase();
+    const auto time_after = std::chrono::steady_clock::now();
+
+    best_ms = std::min(best_ms, std::chrono::duration<double, std::milli> {time_after - time_before}.count());
+
+    return phase_result;
+}
+
+[[nodiscard]] ScalingRow measure_compile_scaling(int function_count) {
+    auto gen_config = Bench::default_gen_config;
+    gen_config.function_count = function_count;
+
+    const auto source = Bench::ProgramGenerator {gen_config}();
+    const std::string_view source_sv {source};
+
+    ScalingRow row {
+        .function_count = function_count,
+        .source_lines = static_cast<std::size_t>(std::ranges::count(source, '\n')),
+        .source_bytes = source.size(),
+        .phase_ms = {},
+        .peak_heap_bytes = 0
+    };
+
+    row.phase_ms.fill(std::numeric_limits<double>::infinity());
+
+    for (auto repeat_idx = 0; repeat_idx < scaling_repeats; ++repeat_idx) {
+        const auto heap_before = g_live_heap_bytes;
+        g_peak_heap_bytes = heap_before;
+
+        [[maybe_unused]] const auto token_count = time_phase(row.phase_ms[0], [source_sv] {
+            Frontend::Lexer lexer {source_sv};
+            std::size_t token_count = 0;
+
+            while (lexer().tag != Frontend::LexTag::eof) {
+                ++token_count;
+            }
+
+            return token_count;
+        });
+
+        Frontend::Parser parser {source_sv};
+        auto [ast, parse_errors] = time_phase(row.phase_ms[1], [&parser] {
+            return parser();
+        });
+
+        if (!parse_errors.empty()) {
+            throw std::logic_error {std::format("Generated program of {} functions has parse errors.", function_count)};
+        }
+
+        Semantics::SemanticsPass sema {source_sv};
+        const auto sema_result = time_phase(row.phase_ms[2], [&sema, &ast] {
+            return sema(ast);
+        });
+
+        if (!sema_result.errors.empty()) {
+            throw std::logic_error {std::format("Generated program of {} functions has semantic errors.", function_count)};
+        }
+
+        Codegen::GraphPass ir_emitter {source_sv, &sema_result.native_hints, &sema_result.operand_hints};
+        const auto ir = time_phase(row.phase_ms[3], [&ir_emitter, &ast] {
+            return ir_emitter.process(ast);
+        });
+
+        const auto& [ir_constants, ir_stack_depths, ir_func_names, ir_graphs, ir_main_id] = ir;
+        Codegen::EmitCodePass bytecode_emitter;
+        [[maybe_unused]] const auto prgm_ptr = time_phase(row.phase_ms[4], [&] {
+            return bytecode_emitter.process_full_ir(ir_constants, ir_stack_depths, ir_func_names, *ir_graphs, ir_main_id);
+        });
+
+        row.peak_heap_bytes = std::max(row.peak_heap_bytes, g_peak_heap_bytes - heap_before);
+    }
+
+    return row;
+}
+
+/// @brief Compiles generated programs of doubling function counts up to `max_functions`, printing how each phase's time and the peak heap grow with the source. With a CSV path, the rows are also written there for plotting.
+[[nodiscard]] int run_scaling(int max_functions, const std::string& csv_path) {
+    std::vector<ScalingRow> rows;
+
+    try {
+        for (auto function_count = scaling_min_functions; function_count <= max_functions; function_count *= 2) {
+            rows.push_back(measure_compile_scaling(function_count));
+        }
+    } catch (const std::exception& bench_error) {
+        std::print(std::cerr, "Benchmark Error:\n{}\n", bench_error.what());
+        return 1;
+    }
+
+    std::string csv_text = "functions,lines,bytes,lex_ms,parse_ms,semantics_ms,graph_ms,emit_ms,total_ms,ns_per_line,peak_heap_bytes\n";
+
+    std::print("{:>10}{:>10}{:>10}", "functions", "lines", "KiB");
+
+    for (const auto phase_name : scaling_phase_names) {
+        std::print("{:>12}", std::format("{} ms", phase_name));
+    }
+
+    std::print("{:>12}{:>12}{:>14}\n", "total ms", "ns/line", "peak heap KiB");
+
+    for (const auto& [function_count, source_lines, source_bytes, phase_ms, peak_heap_bytes] : rows) {
+        const auto total_ms = std::accumulate(phase_ms.begin(), phase_ms.end(), 0.0);
+        const auto ns_per_line = total_ms * 1e6 / static_cast<double>(std::max(source_lines, std::size_t {1}));
+
+        std::print("{:>10}{:>10}{:>10}", function_count, source_lines, source_bytes / 1024);
+        csv_text += std::format("{},{},{}", function_count, source_lines, source_bytes);
+
+        for (const auto ms : phase_ms) {
+            std::print("{:>12.3f}", ms);
+            csv_text += std::format(",{:.3f}", ms);
+        }
+
+        std::print("{:>12.3f}{:>12.0f}{:>14}\n", total_ms, ns_per_line, peak_heap_bytes / 1024);
+        csv_text += std::format(",{:.3f},{:.0f},{}\n", total_ms, ns_per_line, peak_heap_bytes);
+    }
+
+    if (csv_path.empty()) {
+        return 0;
+    }
+
+    std::ofstream csv_writer {csv_path};
+
+    if (!(csv_writer << csv_text)) {
+        std::print(std::cerr, "Cannot write '{}'\n", csv_path);
+        return 1;
+    }
+
+    return 0;
+}
+
+constexpr int gate_compile_functions = 512;
+
+/// @brief Times the whole `compile_source` pipeline, from parsing through emission, on a generated program. Returns the compile throughput in source bytes per second.
+[[nodiscard]] double bench_generated_compile(const BenchOptions& options, std::vector<BenchResult>& results) {
+    auto gen_config = Bench::default_gen_config;
+    gen_config.function_count = gate_compile_functions;
+
+    const auto source = Bench::ProgramGenerator {gen_config}();
+    const std::string_view source_sv {source};
+
+    auto compile_result = time_stage(options, "generated", "compile", [] { return 0; }, [source_sv](int) {
+        Frontend::Parser parser {source_sv};
+        auto [ast, parse_errors] = parser();
+
+        Semantics::SemanticsPass sema {source_sv};
+        const auto sema_result = sema(ast);
+
+        Codegen::GraphPass ir_emitter {source_sv, &sema_result.native_hints, &sema_result.operand_hints};
+        const auto [ir_constants, ir_stack_depths, ir_func_names, ir_graphs, ir_main_id] = ir_emitter.process(ast);
+
+        Codegen::EmitCodePass bytecode_emitter;
+
+        return bytecode_emitter.process_full_ir(ir_constants, ir_stack_depths, ir_func_names, *ir_graphs, ir_main_id);
+    });
+
+    const auto bytes_per_sec = static_cast<double>(source.size()) / (compile_result.best_ns * 1e-9);
+    results.push_back(std::move(compile_result));
+
+    return bytes_per_sec;
+}
+
+/// @note Only throughputs are gated: VM instructions per second per workload and engine, and the generated program's compile bytes per second.
+[[nodiscard]] Bench::BenchMetrics collect_metrics(const std::vector<BenchResult>& results, std::optional<double> compile_bytes_per_sec) {
+    Bench::BenchMetrics metrics;
+
+    for (const auto& result : results) {
+        if (result.instructions_per_sec > 0.0) {
+            metrics.emplace(std::format("{}.{}.instructions_per_sec", result.workload, result.stage), result.instructions_per_sec);
+        }
+    }
+
+    if (compile_bytes_per_sec) {
+        metrics.emplace("generated.compile.bytes_per_sec", *compile_bytes_per_sec);
+    }
+
+    return metrics;
+}
+
+/// @brief Compares fresh metrics against a baseline file. Fails when any baseline metric is missing or fell more than the threshold below its baseline value.
+[[nodiscard]] bool check_against_baseline(const BenchOptions& options, const Bench::BenchMetrics& metrics) {
+    const auto baseline = Bench::read_baseline(options.check_path);
+    const auto floor_ratio = 1.0 - options.threshold_percent / 100.0;
+    auto regressions_n = 0;
+
+    std::print("\n{:<44}{:>16}{:>16}{:>10}\n", std::format("metric (threshold {}%)", options.threshold_percent), "baseline", "current", "change");
+
+    for (const auto& [metric_name, baseline_value] : baseline) {
+        const auto current_it = metrics.find(metric_name);
+
+        if (current_it == metrics.end()) {
+            std::print("{:<44}{:>16.0f}{:>16}{:>10}  MISSING\n", metric_name, baseline_value, "-", "-");
+            ++regressions_n;
+            continue;
+        }
+
+        const auto current_value = current_it->second;
+        const auto change_percent = (baseline_value > 0.0) ? (current_value / baseline_value - 1.0) * 100.0 : 0.0;
+        const auto regressed = current_value < baseline_value * floor_ratio;
+
+        std::print("{:<44}{:>16.0f}{:>16.0f}{:>9.1f}%{}\n", metric_name, baseline_value, current_value, change_percent, regressed ? "  REGRESSED" : "");
+        regressions_n += regressed ? 1 : 0;
+    }
+
+    for (const auto& [metric_name, current_value] : metrics) {
+        if (!baseline.contains(metric_name)) {
+            std::print("{:<44}{:>16}{:>16.0f}{:>10}  NEW\n", metric_name, "-", current_value, "-");
+        }
+    }
+
+    if (regressions_n > 0) {
+        std::print(std::cerr, "{} metric(s) regressed or went missing against '{}'. Refresh the baseline with the bench_baseline target if this is expected.\n", regressions_n, options.check_path);
+    }
+
+    return regressions_n == 0;
+}
+
+int main(int argc, char* argv[]) {
+    constexpr auto usage_text = "usage: xplice_bench [--workloads <dir>] [--analogs <dir>] [--python <path>] [--filter <name-part>] [--min-time-ms <n>] [--json <baseline-path>] [--check <baseline-path> [--threshold <percent>]] | --scaling <max-functions> [--csv <path>]\n";
+
+    BenchOptions options {
+        .workload_dir = XLANG_BENCH_WORKLOAD_DIR,
+        .analog_dir = XLANG_BENCH_ANALOG_DIR,
+        .python_path = {},
+        .filter = {},
+        .min_time = std::chrono::milliseconds {200},
+        .scaling_max_functions = 0,
+        .csv_path = {},
+        .json_path = {},
+        .check_path = {},
+        .threshold_percent = 25.0
+    };
+
+    for (auto arg_idx = 1; arg_idx < argc; ++arg_idx) {
+        const std::string_view option_sv {argv[arg_idx]};
+
+        if (arg_idx + 1 >= argc) {
+            std::print(std::cerr, usage_text);
+            return 1;
+        }
+
+        if (option_sv == "--workloads") {
+            options.workload_dir = argv[++arg_idx];
+        } else if (option_sv == "--analogs") {
+            options.analog_dir = argv[++arg_idx];
+        } else if (option_sv == "--python") {
+            options.python_path = argv[++arg_idx];
+        } else if (option_sv == "--filter") {
+            options.filter = argv[++arg_idx];
+        } else if (option_sv == "--min-time-ms") {
+            const std::string_view time_sv {argv[++arg_idx]};
+            int min_time_ms = 0;
+
+            if (const auto [time_end, time_error] = std::from_chars(time_sv.data(), time_sv.data() + time_sv.size(), min_time_ms); time_error != std::errc {} || time_end != time_sv.data() + time_sv.size() || min_time_ms < 0) {
+                std::print(std::cerr, usage_text);
+                return 1;
+            }
+
+            options.min_time = std::chrono::milliseconds {min_time_ms};
+        } else if (option_sv == "--scaling") {
+            const std::string_view count_sv {argv[++arg_idx]};
+
+            if (const auto [count_end, count_error] = std::from_chars(count_sv.data(), count_sv.data() + count_sv.size(), options.scaling_max_functions); count_error != std::errc {} || count_end != count_sv.data() + count_sv.size() || options.scaling_max_functions < scaling_min_functions) {
+                std::print(std::cerr, usage_text);
+                return 1;
+            }
+        } else if (option_sv == "--csv") {
+            options.csv_path = argv[++arg_idx];
+        } else if (option_sv == "--json") {
+            options.json_path = argv[++arg_idx];
+        } else if (option_sv == "--check") {
+            options.check_path = argv[++arg_idx];
+        } else if (option_sv == "--threshold") {
+            const std::string_view threshold_sv {argv[++arg_idx]};
+
+            if (const auto [threshold_end, threshold_error] = std::from_chars(threshold_sv.data(), threshold_sv.data() + threshold_sv.size(), options.threshold_percent); threshold_error != std::errc {} || threshold_end != threshold_sv.data() + threshold_sv.size() || options.threshold_percent < 0.0 || options.threshold_percent >= 100.0) {
+                std::print(std::cerr, usage_text);
+                return 1;
+            }
+        } else {
+            std::print(std::cerr, usage_text);
+            return 1;
+        }
+    }
+
+    if (options.scaling_max_functions > 0) {
+        return run_scaling(options.scaling_max_functions, options.csv_path);
+    }
+
+    std::vector<std::filesystem::path> workload_paths;
+    std::error_code fs_error;
+
+    for (const auto& dir_entry : std::filesystem::directory_iterator {options.workload_dir, fs_error}) {
+        if (const auto& entry_path = dir_entry.path(); entry_path.extension() == ".xplice" && entry_path.stem().string().find(options.filter) != std::string::npos) {
+            workload_paths.push_back(entry_path);
+        }
+    }
+
+    if (fs_error || workload_paths.empty()) {
+        std::print(std::cerr, "No workloads found in '{}'\n", options.workload_dir.string());
+        return 1;
+    }
+
+    std::ranges::sort(workload_paths);
+
+    std::vector<BenchResult> results;
+    std::optional<double> compile_bytes_per_sec;
+
+    try {
+        for (const auto& workload_path : workload_paths) {
+            bench_workload(options, workload_path, results);
+        }
+
+        if (std::string_view {"generated"}.find(options.filter) != std::string_view::npos) {
+            compile_bytes_per_sec = bench_generated_compile(options, results);
+        }
+    } catch (const std::exception& bench_error) {
+        std::print(std::cerr, "Benchmark Error:\n{}\n", bench_error.what());
+        return 1;
+    }
+
+    std::print("{:<16}{:<14}{:>10}{:>16}{:>16}{:>12}{:>14}{:>14}\n", "workload", "stage", "iters", "ns/op", "best ns", "allocs/op", "bytes/op", "Minstr/s");
+
+    for (const auto& [workload, stage, iterations, ns_per_op, best_ns, allocs_per_op, bytes_per_op, instructions_per_sec] : results) {
+        const auto minstr_text = (instructions_per_sec > 0.0) ? std::format("{:.1f}", instructions_per_sec * 1e-6) : std::string {"-"};
+
+        std::print("{:<16}{:<14}{:>10}{:>16.0f}{:>16.0f}{:>12.1f}{:>14.0f}{:>14}\n", workload, stage, iterations, ns_per_op, best_ns, allocs_per_op, bytes_per_op, minstr_text);
+    }
+
+    compare_with_python(options, workload_paths, results);
+
+    const auto metrics = collect_metrics(results, compile_bytes_per_sec);
+
+    try {
+        if (!options.json_path.empty()) {
+            Bench::write_baseline(options.json_path, metrics);
+            std::print("\nWrote {} metric(s) to '{}'\n", metrics.size(), options.json_path);
+        }
+
+        if (!options.check_path.empty() && !check_against_baseline(options, metrics)) {
+            return 1;
+        }
+    } catch (const std::exception& baseline_error) {
+        std::print(std::cerr, "Baseline Error:\n{}\n", baseline_error.what());
+        return 1;
+    }
+}
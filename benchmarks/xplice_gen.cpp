@@ -0,0 +1,74 @@
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include "program_gen.hpp"
+
+using namespace XLang;
+
+[[nodiscard]] bool parse_count(std::string_view count_sv, int& count) {
+    const auto [count_end, count_error] = std::from_chars(count_sv.data(), count_sv.data() + count_sv.size(), count);
+
+    return count_error == std::errc {} && count_end == count_sv.data() + count_sv.size() && count >= 0;
+}
+
+int main(int argc, char* argv[]) {
+    constexpr auto usage_text = "usage: xplice_gen [--functions <n>] [--depth <n>] [--expr-size <n>] [--locals <n>] [--seed <n>] [--out <path>]\n";
+
+    auto config = Bench::default_gen_config;
+    std::string out_path;
+
+    for (auto arg_idx = 1; arg_idx < argc; ++arg_idx) {
+        const std::string_view option_sv {argv[arg_idx]};
+
+        if (arg_idx + 1 >= argc) {
+            std::print(std::cerr, usage_text);
+            return 1;
+        }
+
+        const std::string_view value_sv {argv[++arg_idx]};
+        int count = 0;
+
+        if (option_sv == "--out") {
+            out_path = value_sv;
+            continue;
+        }
+
+        if (!parse_count(value_sv, count)) {
+            std::print(std::cerr, usage_text);
+            return 1;
+        }
+
+        if (option_sv == "--functions") {
+            config.function_count = count;
+        } else if (option_sv == "--depth") {
+            config.nesting_depth = count;
+        } else if (option_sv == "--expr-size") {
+            config.expr_size = count;
+        } else if (option_sv == "--locals") {
+            config.identifier_count = count;
+        } else if (option_sv == "--seed") {
+            config.seed = static_cast<std::uint32_t>(count);
+        } else {
+            std::print(std::cerr, usage_text);
+            return 1;
+        }
+    }
+
+    const auto program_text = Bench::ProgramGenerator {config}();
+
+    if (out_path.empty()) {
+        std::cout << program_text;
+        return 0;
+    }
+
+    std::ofstream writer {out_path, std::ios::binary};
+
+    if (!writer.write(program_text.data(), static_cast<std::streamsize>(program_text.size()))) {
+        std::print(std::cerr, "Cannot write '{}'\n", out_path);
+        return 1;
+    }
+}
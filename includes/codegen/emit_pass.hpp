@@ -2,8 +2,11 @@
 
 #include <utility>
 #include <memory>
+#include <optional>
 #include <set>
 #include <stack>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include "codegen/policies.hpp"
 #include "codegen/steps.hpp"
@@ -51,7 +54,7 @@ namespace XLang::Codegen {
     class EmitCodePass {
     public:
         EmitCodePass()
-        : m_result {std::make_unique<VM::XpliceProgram>()}, m_constant_chunks_view {nullptr}, m_ir_unit_idx {0} {}
+        : m_result {std::make_unique<VM::XpliceProgram>()}, m_constant_chunks_view {nullptr}, m_stack_depths_view {nullptr}, m_line_table {}, m_ir_unit_idx {0} {}
 
         [[nodiscard]] Result process(const FlowGraph& control_graph) {
             VM::ConstantStore temp_constants = emit_constant_region(m_constant_chunks_view->at(m_ir_unit_idx));
@@ -60,18 +63,25 @@ namespace XLang::Codegen {
 
             return {
                 .constants = std::move(temp_constants),
-                .bytecode = std::move(temp_bytecode)
+                .bytecode = std::move(temp_bytecode),
+                .max_stack_depth = m_stack_depths_view->at(m_ir_unit_idx)
             };
         }
 
-        /// @note Takes in properties of IRStore to create a XpliceProgram structure for the VM.
-        std::unique_ptr<VM::XpliceProgram> process_full_ir(const std::vector<ProtoConstMap>& constants, const Codegen::FlowStore& cfg_dict, int entry_point_id) {
+        /// @note Takes in properties of IRStore to create a XpliceProgram structure for the VM. Each function's name and pc-to-line table go into its debug info.
+        std::unique_ptr<VM::XpliceProgram> process_full_ir(const std::vector<ProtoConstMap>& constants, const std::vector<int>& max_stack_depths, const std::vector<std::string_view>& func_names, const Codegen::FlowStore& cfg_dict, int entry_point_id) {
             m_constant_chunks_view = &constants;
+            m_stack_depths_view = &max_stack_depths;
 
             m_result.get()->entry_func_id = entry_point_id;
 
             for (const auto& temp_cfg : cfg_dict) {
-                m_result.get()->func_chunks.operator[](m_ir_unit_idx) = process(temp_cfg);
+                /// @note Chunks are appended in function id order, so each one lands at its id's index.
+                m_result.get()->func_chunks.emplace_back(process(temp_cfg));
+                m_result.get()->debug_funcs.emplace_back(VM::FunctionDebugInfo {
+                    .name = std::string {func_names.at(m_ir_unit_idx)},
+                    .lines = std::move(m_line_table)
+                });
                 clear_current_state();
             }
 
@@ -81,19 +91,29 @@ namespace XLang::Codegen {
     private:
         static constexpr auto dud_pos = -1;
 
+        /// @note `OptimizeL0` emits steps exactly as the IR lists them, and every other policy fuses common runs into superinstructions.
+        static constexpr bool cm_fuse_steps = !std::is_same_v<Policy, Codegen::OptimizeL0>;
+
         /// @note Stores bytecode program being built: "VM-ProgramStore"
         std::unique_ptr<VM::XpliceProgram> m_result;
 
         const std::vector<ProtoConstMap>* m_constant_chunks_view;
 
+        const std::vector<int>* m_stack_depths_view;
+
+        /// @note Line table of the function being emitted, keyed by instruction index.
+        std::vector<VM::LineEntry> m_line_table;
+
         int m_ir_unit_idx;
 
         void clear_current_state() {
+            m_line_table.clear();
             ++m_ir_unit_idx;
         }
 
         [[nodiscard]] VM::ConstantStore emit_constant_region(const ProtoConstMap& ir_constant_dict) {
             VM::ConstantStore const_region;
+            const_region.resize(ir_constant_dict.size());
 
             for (const auto& entry : ir_constant_dict) {
                 const auto entry_id = entry.second.id;
@@ -117,9 +137,116 @@ namespace XLang::Codegen {
             return const_region;
         }
 
+        /// @note Yields the source of a step that only pushes one readable slot or constant, which fused instructions can read in place.
+        [[nodiscard]] static std::optional<Locator> fusable_operand(const StepUnion& step) noexcept {
+            if (!std::holds_alternative<UnaryStep>(step)) {
+                return {};
+            }
+
+            const auto& [step_op, step_arg] = std::get<UnaryStep>(step);
+
+            if (step_op == VM::Opcode::xop_load_const) {
+                return step_arg;
+            }
+
+            if (step_op == VM::Opcode::xop_push && (step_arg.region == Region::consts || step_arg.region == Region::temp_stack || step_arg.region == Region::frame_slot)) {
+                return step_arg;
+            }
+
+            return {};
+        }
+
+        [[nodiscard]] static constexpr VM::Opcode fused_store_opcode(VM::Opcode op) noexcept {
+            switch (op) {
+            case VM::Opcode::xop_add_i32: return VM::Opcode::xop_add_i32_store;
+            case VM::Opcode::xop_sub_i32: return VM::Opcode::xop_sub_i32_store;
+            case VM::Opcode::xop_mul_i32: return VM::Opcode::xop_mul_i32_store;
+            case VM::Opcode::xop_add_f32: return VM::Opcode::xop_add_f32_store;
+            case VM::Opcode::xop_sub_f32: return VM::Opcode::xop_sub_f32_store;
+            case VM::Opcode::xop_mul_f32: return VM::Opcode::xop_mul_f32_store;
+            default: return VM::Opcode::xop_noop;
+            }
+        }
+
+        [[nodiscard]] static constexpr VM::Opcode fused_branch_opcode(VM::Opcode op) noexcept {
+            switch (op) {
+            case VM::Opcode::xop_cmp_eq_i32: return VM::Opcode::xop_jump_not_eq_i32;
+            case VM::Opcode::xop_cmp_ne_i32: return VM::Opcode::xop_jump_not_ne_i32;
+            case VM::Opcode::xop_cmp_lt_i32: return VM::Opcode::xop_jump_not_lt_i32;
+            case VM::Opcode::xop_cmp_gt_i32: return VM::Opcode::xop_jump_not_gt_i32;
+            case VM::Opcode::xop_cmp_eq_f32: return VM::Opcode::xop_jump_not_eq_f32;
+            case VM::Opcode::xop_cmp_ne_f32: return VM::Opcode::xop_jump_not_ne_f32;
+            case VM::Opcode::xop_cmp_lt_f32: return VM::Opcode::xop_jump_not_lt_f32;
+            case VM::Opcode::xop_cmp_gt_f32: return VM::Opcode::xop_jump_not_gt_f32;
+            default: return VM::Opcode::xop_noop;
+            }
+        }
+
+        /**
+         * @brief Peephole pass over one Unit's steps. Rewrites `<operand> <operand> <typed arith> replace` into one `*_store` instruction and `<operand> <operand> <typed cmp> jump_not_if` into one `jump_not_*` instruction. Jumps only target Unit starts and `noop` steps, so no target can fall inside a fused run.
+         * @note Fused args are ordered (target, lhs, rhs) where lhs is the later push, matching the stack handlers' pop order. Branches keep their target in arg 0 so backpatching is unchanged. A fused step keeps the line of its first step in `fused_lines`.
+         */
+        [[nodiscard]] static StepSequence fuse_steps(const StepSequence& steps, const std::vector<int>& step_lines, std::vector<int>& fused_lines) {
+            StepSequence result;
+            const auto steps_n = static_cast<int>(steps.size());
+            auto step_idx = 0;
+
+            result.reserve(steps.size());
+            fused_lines.clear();
+            fused_lines.reserve(steps.size());
+
+            while (step_idx < steps_n) {
+                if (step_idx + 3 < steps_n && std::holds_alternative<NonaryStep>(steps[step_idx + 2]) && std::holds_alternative<UnaryStep>(steps[step_idx + 3])) {
+                    const auto rhs_operand = fusable_operand(steps[step_idx]);
+                    const auto lhs_operand = fusable_operand(steps[step_idx + 1]);
+                    const auto middle_op = std::get<NonaryStep>(steps[step_idx + 2]).op;
+                    const auto& [tail_op, tail_arg] = std::get<UnaryStep>(steps[step_idx + 3]);
+
+                    if (rhs_operand && lhs_operand) {
+                        const auto store_op = fused_store_opcode(middle_op);
+                        const auto branch_op = fused_branch_opcode(middle_op);
+
+                        if (store_op != VM::Opcode::xop_noop && tail_op == VM::Opcode::xop_replace && tail_arg.region == Region::temp_stack) {
+                            result.emplace_back(TernaryStep {store_op, tail_arg, *lhs_operand, *rhs_operand});
+                            fused_lines.push_back(step_lines[step_idx]);
+                            step_idx += 4;
+                            continue;
+                        } else if (branch_op != VM::Opcode::xop_noop && tail_op == VM::Opcode::xop_jump_not_if) {
+                            result.emplace_back(TernaryStep {branch_op, tail_arg, *lhs_operand, *rhs_operand});
+                            fused_lines.push_back(step_lines[step_idx]);
+                            step_idx += 4;
+                            continue;
+                        }
+                    }
+                }
+
+                result.emplace_back(steps[step_idx]);
+                fused_lines.push_back(step_lines[step_idx]);
+                ++step_idx;
+            }
+
+            return result;
+        }
+
+        /// @note Every push source region is known at compile time, so pick its dedicated opcode and spare the VM a region switch. Constants reuse `load_const`.
+        [[nodiscard]] static constexpr VM::Opcode specialized_push_opcode(const Locator& arg) noexcept {
+            switch (arg.region) {
+            case Region::consts: return VM::Opcode::xop_load_const;
+            case Region::temp_stack: return VM::Opcode::xop_push_local;
+            case Region::frame_slot: return VM::Opcode::xop_push_arg;
+            case Region::routines: return VM::Opcode::xop_push_func;
+            default: return VM::Opcode::xop_push;
+            }
+        }
+
+        [[nodiscard]] static constexpr bool is_conditional_jump(VM::Opcode op) noexcept {
+            return op == VM::Opcode::xop_jump_not_if || (op >= VM::Opcode::xop_jump_not_eq_i32 && op <= VM::Opcode::xop_jump_not_gt_f32);
+        }
+
         [[nodiscard]] std::vector<VM::RuntimeByte> emit_instruction_region(const std::vector<NodeUnion>& ir_steps) {
             std::vector<VM::RuntimeByte> result;
             auto byte_total = 0;
+            auto instruction_total = 0;
 
             /// @note Stores next nodes by ID to emit bytecode for, etc.
             std::stack<int> incoming;
@@ -136,6 +263,9 @@ namespace XLang::Codegen {
             /// @note stores previous byte location for any back jumps
             auto prev_temp_patch_pos = 0;
 
+            /// @note Lines of the current Unit's steps after fusion.
+            std::vector<int> fused_lines;
+
             auto emit_opcode = [&result, &byte_total](VM::Opcode opcode) {
                 result.push_back(static_cast<VM::RuntimeByte>(opcode));
                 ++byte_total;
@@ -154,18 +284,24 @@ namespace XLang::Codegen {
                 byte_total += 4;
             };
 
-            auto emit_step = [&](const StepUnion& step) {
+            auto emit_step = [&](const StepUnion& step, int source_line) {
                 const auto step_var_idx = step.index();
                 const auto instruction_pos = byte_total;
                 VM::Opcode passed_op = VM::Opcode::xop_noop;
 
+                if (m_line_table.empty() || m_line_table.back().line != source_line) {
+                    m_line_table.push_back({instruction_total, source_line});
+                }
+
+                ++instruction_total;
+
                 if (step_var_idx == 0) {
                     const auto& [nonary_op] = std::get<NonaryStep>(step);
                     emit_opcode(nonary_op);
                     passed_op = nonary_op;
                 } else if (step_var_idx == 1) {
                     const auto& [unary_op, unary_arg0] = std::get<UnaryStep>(step);
-                    emit_opcode(unary_op);
+                    emit_opcode((unary_op == VM::Opcode::xop_push) ? specialized_push_opcode(unary_arg0) : unary_op);
                     emit_arg(unary_arg0);
                     passed_op = unary_op;
                 } else if (step_var_idx == 2) {
@@ -185,7 +321,7 @@ namespace XLang::Codegen {
 
                 const auto [hint_start_pos, hint_mode] = patch_hints.top();
 
-                if (passed_op == VM::Opcode::xop_jump_not_if) {
+                if (is_conditional_jump(passed_op)) {
                     patches.emplace(Backpatch {
                         .status = PatchStatus::patch_skip_truthy,
                         .jump_pos = instruction_pos,
@@ -255,14 +391,22 @@ namespace XLang::Codegen {
                 const auto temp_emit_start_pos = static_cast<int>(result.size());
 
                 if (std::holds_alternative<Unit>(ir_unit)) {
-                    const auto& [steps, next_id] = std::get<Unit>(ir_unit);
+                    const auto& [steps, step_lines, next_id] = std::get<Unit>(ir_unit);
 
                     if (visited.contains(next_id)) {
                         patch_hints.top().mode = PatchMode::patch_mode_while;
                     }
 
-                    for (const auto& step : steps) {
-                        emit_step(step);
+                    if constexpr (cm_fuse_steps) {
+                        const auto fused_steps = fuse_steps(steps, step_lines, fused_lines);
+
+                        for (std::size_t step_idx = 0; step_idx < fused_steps.size(); ++step_idx) {
+                            emit_step(fused_steps[step_idx], fused_lines[step_idx]);
+                        }
+                    } else {
+                        for (std::size_t step_idx = 0; step_idx < steps.size(); ++step_idx) {
+                            emit_step(steps[step_idx], step_lines[step_idx]);
+                        }
                     }
 
                     /// @note Save previous byte position in case a while test's position needs to be patched into a jump...
@@ -23,6 +23,8 @@ namespace XLang::Codegen {
     /// @note Represents a non-forking sequence of instructions.
     struct Unit {
         StepSequence steps;
+        /// @note Source line of each step, parallel to `steps`.
+        std::vector<int> step_lines;
         int next;
     };
 
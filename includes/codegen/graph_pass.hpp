@@ -3,6 +3,7 @@
 #include <memory>
 #include <array>
 #include <any>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -28,6 +29,10 @@ namespace XLang::Codegen {
 
     struct IRStore {
         std::vector<ProtoConstMap> const_chunks;
+        /// @note Peak stack score per function, in function id order.
+        std::vector<int> max_stack_depths;
+        /// @note Declared function names, in function id order.
+        std::vector<std::string_view> func_names;
         std::unique_ptr<FlowStore> func_cfgs;
         int main_func_id;
     };
@@ -55,37 +60,6 @@ namespace XLang::Codegen {
      */
     class GraphPass : public Syntax::ExprVisitor<std::any>, public Syntax::StmtVisitor<std::any> {
     private:
-        /// @note indicates deltas of stack change by opcode... -100 means the opcode clears the callee's stack frame, thus needing a reset of the simulated stack frame score.
-        static constexpr std::array<int, static_cast<std::size_t>(VM::Opcode::last)> m_op_stack_deltas = {
-            -100,
-            0,
-            -1,
-            1,
-            -1,
-            1,
-            1,
-            0,
-            0,
-            1,
-            0,
-            -1,
-            -1,
-            -1,
-            -1,
-            -1,
-            -1,
-            -1,
-            -1,
-            -1,
-            -1,
-            0,
-            -1,
-            -1,
-            -100,
-            1,
-            1
-        };
-
         enum class OpLeaning {
             lean_left,
             lean_right,
@@ -100,6 +74,9 @@ namespace XLang::Codegen {
         /// @note Stores compiled constant primitives per function chunk.
         std::vector<ProtoConstMap> m_func_consts;
 
+        /// @note Stores the peak stack score per function chunk.
+        std::vector<int> m_func_max_stack_scores;
+
         /// @note refers new nodes to connect later
         std::vector<NodeUnion> m_nodes;
 
@@ -113,8 +90,14 @@ namespace XLang::Codegen {
 
         const Semantics::NativeHints* m_native_hints_p;
 
+        const Semantics::OperandHints* m_operand_hints_p;
+
         /// @note simulates size of a callee's stack values frame
         int m_stack_score;
+        int m_max_stack_score;
+
+        /// @note Line of the latest token visited, which steps placed next are attributed to.
+        int m_current_line;
 
         int m_main_func_idx;
 
@@ -129,7 +112,11 @@ namespace XLang::Codegen {
         [[nodiscard]] Locator lookup_named_location(std::string_view name) const;
         [[nodiscard]] Locator lookup_callable_name(std::string_view name) const;
 
+        /// @note Yields the shared operand type proven by semantic analysis, or `x_type_unknown` when the generic opcode must be used.
+        [[nodiscard]] Semantics::TypeTag lookup_operand_type(const Syntax::Binary& expr) const noexcept;
+
         void commit_current_consts();
+        void commit_max_stack_score();
 
         void update_stack_score_delta(const StepUnion& step);
         void leave_record();
@@ -144,9 +131,10 @@ namespace XLang::Codegen {
         [[nodiscard]] std::any help_gen_compare(OpLeaning op_lean, const Syntax::Binary& expr);
         [[nodiscard]] std::any help_gen_logical(const Syntax::Binary& expr);
         [[nodiscard]] std::any help_gen_assign(const Syntax::Binary& expr);
+        void help_gen_call_args(const Syntax::Call& expr);
 
     public:
-        GraphPass(std::string_view old_source, const Semantics::NativeHints* native_hints_p_) noexcept;
+        GraphPass(std::string_view old_source, const Semantics::NativeHints* native_hints_p_, const Semantics::OperandHints* operand_hints_p_) noexcept;
 
         [[nodiscard]] std::any visit_literal(const Syntax::Literal& expr) override;
         [[nodiscard]] std::any visit_unary(const Syntax::Unary& expr) override;
@@ -42,9 +42,13 @@ namespace XLang::Semantics {
         friend std::string stringify_sema_dump(const SemanticDump& dump);
     };
 
+    /// @note Maps each arithmetic or comparison expression to the primitive type both of its operands share, so codegen can pick typed opcodes.
+    using OperandHints = std::unordered_map<const Syntax::Binary*, TypeTag>;
+
     struct SemanticResult {
         std::unordered_map<std::string_view, SemanticNativeEntry> native_hints;
         std::vector<SemanticDump> errors;
+        OperandHints operand_hints;
     };
 
     using Scope = std::unordered_map<std::string_view, SemanticEntry>;
@@ -89,6 +93,7 @@ namespace XLang::Semantics {
         };
 
         NativeHints m_native_hints;
+        OperandHints m_operand_hints;
         std::vector<Scope> m_scopes;
         SemanticLocation m_location;
         SemanticDiagnoses m_result;
@@ -103,6 +108,8 @@ namespace XLang::Semantics {
 
         void record_native_name(std::string_view name, TypeInfo info);
 
+        void record_operand_hint(const Syntax::Binary& expr, TypeTag lhs_type, TypeTag rhs_type);
+
         /// @note If the name is undeclared, the TypeInfo contains a NullType.
         [[nodiscard]] TypeInfo resolve_type_from(std::string_view name);
         [[nodiscard]] OpTypeCheckResult check_type_operation(OpTag op, const TypeInfo& arg_typing);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <any>
+#include <cstddef>
+#include <vector>
+#include "syntax/expr_visitor_base.hpp"
+#include "syntax/exprs.hpp"
+#include "syntax/stmt_visitor_base.hpp"
+#include "syntax/stmts.hpp"
+
+namespace XLang::Syntax {
+    /**
+     * @brief Counts every statement and expression node of an AST, as reported by `xplice --time-passes`.
+     */
+    class NodeCounter : public ExprVisitor<std::any>, public StmtVisitor<std::any> {
+    public:
+        NodeCounter() noexcept;
+
+        [[nodiscard]] std::any visit_literal(const Literal& expr) override;
+        [[nodiscard]] std::any visit_unary(const Unary& expr) override;
+        [[nodiscard]] std::any visit_binary(const Binary& expr) override;
+        [[nodiscard]] std::any visit_call(const Call& expr) override;
+
+        [[nodiscard]] std::any visit_native_use(const NativeUse& stmt) override;
+        [[nodiscard]] std::any visit_import(const Import& stmt) override;
+        [[nodiscard]] std::any visit_variable_decl(const VariableDecl& stmt) override;
+        [[nodiscard]] std::any visit_function_decl(const FunctionDecl& stmt) override;
+        [[nodiscard]] std::any visit_expr_stmt(const ExprStmt& stmt) override;
+        [[nodiscard]] std::any visit_block(const Block& stmt) override;
+        [[nodiscard]] std::any visit_return(const Return& stmt) override;
+        [[nodiscard]] std::any visit_if(const If& stmt) override;
+        [[nodiscard]] std::any visit_while(const While& stmt) override;
+
+        [[nodiscard]] std::size_t operator()(const std::vector<StmtPtr>& ast);
+
+    private:
+        std::size_t m_count;
+    };
+}
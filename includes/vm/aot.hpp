@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <limits>
+#include <ostream>
+#include <vector>
+#include "vm/chunk.hpp"
+#include "vm/vm.hpp"
+
+namespace XLang::VM {
+    /**
+     * @brief Runtime state for a program compiled ahead of time with `xplice --emit-cpp`. It holds the host's native table and records the first fault, just like the VM.
+     * @note Natives take a `VM*` to push their result, so the host keeps an idle VM over a lone `HALT` only for that.
+     */
+    class AotHost {
+    public:
+        AotHost();
+
+        /// @note Same id rules as `VM::add_native_function`.
+        void add_native_function(int native_id, const NativeFunction& func);
+
+        /// @note Runs a native over its arguments in source order, storing its one pushed result in `result`.
+        [[nodiscard]] Errcode call_native(int native_id, ArgView args, Value& result) noexcept;
+
+        /// @note Records the first fault and passes `code` through, so generated code can `return host.raise_fault(...)`.
+        [[nodiscard]] Errcode raise_fault(Errcode code, const char* message) noexcept;
+
+        [[nodiscard]] const char* fault_message() const noexcept;
+
+    private:
+        VM m_native_vm;
+        std::vector<NativeFunction> m_native_funcs;
+        const char* m_fault_message;
+    };
+
+    /// @brief Defined by the C++ file `emit_cpp_program` writes. Runs the program's entry function and maps its result like `VM::run`.
+    [[nodiscard]] Errcode run_aot_program(AotHost& host);
+
+    /**
+     * @brief Writes a program as one C++ translation unit. Every function becomes a C++ function over its register code, see `lower_to_registers`, with frame registers in a local array and jumps as `goto`s.
+     * @note Typed operations unbox to plain `int` / `float` arithmetic, which the host compiler can keep in machine registers. Generic operations still go through `Value`.
+     */
+    void emit_cpp_program(const XpliceProgram& prgm, std::ostream& out);
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
+#include <span>
+#include <string>
 #include <utility>
-#include <unordered_map>
 #include <vector>
 #include "vm/tags.hpp"
 #include "vm/values.hpp"
@@ -15,17 +17,42 @@ namespace XLang::VM {
     class Function {};
 
     using RuntimeByte = unsigned char;
-    using ArgStore = std::vector<Value>;
-    using ConstantStore = std::unordered_map<int, Value>;
+    /// @note Views arguments in place on the value stack, first argument at index 0.
+    using ArgView = std::span<const Value>;
+    /// @note Dense, indexed by constant id.
+    using ConstantStore = std::vector<Value>;
     using NativeFunction = Function<RoutineType::xrt_native>;
     using ProgramFunction = Function<RoutineType::xrt_virtual>;
-    using FunctionStore = std::unordered_map<int, ProgramFunction>;
+    /// @note Dense, indexed by function id.
+    using FunctionStore = std::vector<ProgramFunction>;
+
+    /// @brief Read-only view of one function's constants and bytecode, over either a `Chunk` or a mapped `.xpc` image.
+    struct ChunkView {
+        std::span<const Value> constants;
+        std::span<const RuntimeByte> bytecode;
+        int max_stack_depth;
+    };
 
     struct Chunk {
         ConstantStore constants;
         std::vector<RuntimeByte> bytecode;
+        /// @note Most values the function keeps above its frame base, as estimated by `GraphPass`. Calls reserve this much value stack up front.
+        int max_stack_depth;
+
+        [[nodiscard]] ChunkView view() const noexcept {
+            return {constants, bytecode, max_stack_depth};
+        }
+    };
+
+    /// @brief Fixed-width form of one bytecode instruction, decoded once at load time so the VM never re-reads raw bytes. Jump targets and `next` are instruction indices instead of byte offsets.
+    struct Instruction {
+        std::array<Codegen::Locator, 3> args;
+        Opcode op;
+        int next;
     };
 
+    using InstructionStore = std::vector<Instruction>;
+
     template <>
     class Function <RoutineType::xrt_virtual> {
     private:
@@ -45,7 +72,7 @@ namespace XLang::VM {
     template <>
     class Function <RoutineType::xrt_native> {
     public:
-        using native_func_type = Errcode(VM*, const ArgStore&);
+        using native_func_type = Errcode(VM*, ArgView);
         using native_func_ptr = native_func_type*;
 
     private:
@@ -63,13 +90,27 @@ namespace XLang::VM {
         }
 
         template <typename Runtime>
-        [[nodiscard]] Errcode invoke(Runtime& vm, const ArgStore& args) const {
+        [[nodiscard]] Errcode invoke(Runtime& vm, ArgView args) const {
             return vm.invoke_native_func(*this, args);
         }
     };
 
+    /// @brief Starts a run of instructions compiled from one source line. `pc` is a stack-code instruction index, as in `FaultInfo`.
+    struct LineEntry {
+        int pc;
+        int line;
+    };
+
+    /// @brief Names a function and maps its instructions back to source lines for profiler reports. Sorted by `pc`.
+    struct FunctionDebugInfo {
+        std::string name;
+        std::vector<LineEntry> lines;
+    };
+
     struct XpliceProgram {
         FunctionStore func_chunks;
         int entry_func_id;
+        /// @note Indexed by function id. Empty for programs loaded from `.xpc` images, which carry no debug info.
+        std::vector<FunctionDebugInfo> debug_funcs;
     };
 }
\ No newline at end of file
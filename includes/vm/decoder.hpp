@@ -0,0 +1,8 @@
+#pragma once
+
+#include "vm/chunk.hpp"
+
+namespace XLang::VM {
+    /// @brief Translates a chunk's raw bytecode into pre-decoded instructions. Throws `std::runtime_error` on illegal opcodes, truncated instructions, or jumps that miss an instruction boundary.
+    [[nodiscard]] InstructionStore decode_chunk(ChunkView chunk);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+#include "vm/chunk.hpp"
+#include "vm/lowering.hpp"
+#include "vm/stacks.hpp"
+
+namespace XLang::VM {
+    /**
+     * @brief Baseline template JIT for x86-64 hosts. It stitches one machine-code template per register-code instruction into an executable buffer, so compiled frames share the register engine's layout: frame register R lives at `frame[R]` and argument N at `frame[-1 - N]`.
+     * @note Only functions whose whole call graph stays in compiled code are accepted, which rules out natives and heap objects. Compiled code is therefore side-effect free, so any fault or call past the VM's stack limits simply bails out and the VM re-runs the call in its interpreter, which then reports the fault as usual.
+     */
+    class TemplateJit {
+    public:
+        /// @note Calls a function takes in the interpreter before it gets compiled.
+        static constexpr int cm_hot_call_threshold = 64;
+
+        /// @note `funcs` must outlive the JIT, as compiled code reads constants in place. The JIT stack is reserved to `stack_config.value_stack_limit` values.
+        TemplateJit(std::span<const ChunkView> funcs, std::vector<RegisterCode> func_code, const StackConfig& stack_config);
+        ~TemplateJit();
+
+        TemplateJit(const TemplateJit&) = delete;
+        TemplateJit& operator=(const TemplateJit&) = delete;
+
+        [[nodiscard]] static bool is_supported_host() noexcept;
+
+        [[nodiscard]] bool is_compiled(int func_id) const noexcept;
+
+        /// @note Compiles the function along with every function it can reach. Returns false when it is not compilable or code space ran out.
+        [[nodiscard]] bool compile(int func_id);
+
+        /**
+         * @brief Runs a compiled function over a copy of its arguments.
+         * @param frame_args Arguments in value-stack order, so the last argument comes first.
+         * @param frames_left Frames the VM's call stack can still take, which compiled calls may not exceed.
+         * @param values_left Value-stack slots left from the first argument up, so compiled frames fault where interpreted ones would.
+         * @return The result, or nothing when the compiled code bailed out.
+         * @note A function that bailed out once is left to the interpreter from then on. Otherwise every interpreted frame of a recursion too deep for the stack limits would retry it, turning linear work quadratic.
+         */
+        [[nodiscard]] std::optional<Value> invoke(int func_id, std::span<const Value> frame_args, int frames_left, int values_left) noexcept;
+
+    private:
+        /// @note Finds every function whose opcodes and callees are all supported, as a fixed point over the call graph.
+        void mark_compilable();
+
+        [[nodiscard]] bool emit_function(int func_id);
+
+        std::span<const ChunkView> m_funcs;
+        std::vector<RegisterCode> m_func_code;
+        std::vector<bool> m_compilable;
+        std::vector<bool> m_bailed_out;
+
+        /// @note Entry point per function id, read by compiled calls at run time. Null until compiled.
+        std::vector<const void*> m_entries;
+
+        unsigned char* m_code_buffer;
+        std::size_t m_code_used;
+
+        Value* m_jit_stack;
+        std::size_t m_jit_stack_values;
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "vm/chunk.hpp"
+
+namespace XLang::VM {
+    /// @brief One function in three-address form for the register engine, with the number of frame registers it needs.
+    struct RegisterCode {
+        InstructionStore code;
+        /// @note Stack-code index each register instruction was lowered from, so pcs can be reported against the stack code's line table.
+        std::vector<int> stack_pcs;
+        int register_count;
+    };
+
+    /**
+     * @brief Lowers a function's pre-decoded stack instructions into register code. Every value-stack slot becomes a fixed frame register, so `temp_stack:N` still names local N, while pushes, pops, and `replace` moves fold into the operands of the instruction consuming them.
+     * @note Register code reuses `Opcode` with three-address args `(dst, lhs, rhs)` or `(target, lhs, rhs)`. An operand is `consts:K` or `temp_stack:R` for frame register R, where a negative R names argument `-R - 1` just below the frame. Calls pass `temp_stack:B` as the callee's frame base, and the result lands in the caller's register `B - argc`. A tail call passes the same args but reuses the caller's frame.
+     */
+    [[nodiscard]] RegisterCode lower_to_registers(const InstructionStore& stack_code);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "vm/tags.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define XLANG_PROFILE_RDTSC 1
+#else
+#define XLANG_PROFILE_RDTSC 0
+#endif
+
+namespace XLang::VM {
+    /// @brief Dispatch policy that records nothing, so the engines compile exactly as they would without a hook.
+    struct NoProfiling {
+        void on_instruction([[maybe_unused]] int func_id, [[maybe_unused]] Opcode op) noexcept {}
+        void finish() noexcept {}
+    };
+
+    /**
+     * @brief Dispatch policy behind `xplice --profile`. Counts executions and accumulates elapsed ticks per opcode and per function id, plus how often each opcode follows another.
+     * @note Ticks come from `rdtsc` on x86 hosts and `std::chrono::steady_clock` nanoseconds elsewhere. An instruction is charged the ticks until the next one starts, so time inside natives and compiled JIT code lands on the call that entered it.
+     */
+    class OpcodeProfiler {
+    public:
+        static constexpr auto cm_opcode_count = static_cast<std::size_t>(Opcode::last);
+
+        explicit OpcodeProfiler(int funcs_n)
+        : m_op_counts {}, m_op_ticks {}, m_bigram_counts {}, m_func_counts (funcs_n, 0), m_func_ticks (funcs_n, 0), m_last_tick {0}, m_last_func_id {-1}, m_last_op {Opcode::last} {}
+
+        [[nodiscard]] static constexpr std::string_view tick_unit() noexcept {
+            return XLANG_PROFILE_RDTSC ? "cycles" : "ns";
+        }
+
+        void on_instruction(int func_id, Opcode op) noexcept {
+            const auto now = read_ticks();
+            const auto op_id = static_cast<std::size_t>(op);
+
+            if (m_last_op != Opcode::last) {
+                const auto last_op_id = static_cast<std::size_t>(m_last_op);
+
+                m_op_ticks[last_op_id] += now - m_last_tick;
+                m_func_ticks[m_last_func_id] += now - m_last_tick;
+                ++m_bigram_counts[last_op_id * cm_opcode_count + op_id];
+            }
+
+            ++m_op_counts[op_id];
+            ++m_func_counts[func_id];
+
+            m_last_tick = now;
+            m_last_func_id = func_id;
+            m_last_op = op;
+        }
+
+        /// @note Charges the final instruction of a run.
+        void finish() noexcept {
+            if (m_last_op != Opcode::last) {
+                const auto elapsed = read_ticks() - m_last_tick;
+
+                m_op_ticks[static_cast<std::size_t>(m_last_op)] += elapsed;
+                m_func_ticks[m_last_func_id] += elapsed;
+                m_last_op = Opcode::last;
+            }
+        }
+
+        [[nodiscard]] const std::array<std::uint64_t, cm_opcode_count>& op_counts() const noexcept {
+            return m_op_counts;
+        }
+
+        [[nodiscard]] const std::array<std::uint64_t, cm_opcode_count>& op_ticks() const noexcept {
+            return m_op_ticks;
+        }
+
+        /// @note Indexed by `first * cm_opcode_count + second`.
+        [[nodiscard]] const std::array<std::uint64_t, cm_opcode_count * cm_opcode_count>& bigram_counts() const noexcept {
+            return m_bigram_counts;
+        }
+
+        [[nodiscard]] const std::vector<std::uint64_t>& func_counts() const noexcept {
+            return m_func_counts;
+        }
+
+        [[nodiscard]] const std::vector<std::uint64_t>& func_ticks() const noexcept {
+            return m_func_ticks;
+        }
+
+    private:
+        [[nodiscard]] static std::uint64_t read_ticks() noexcept {
+#if XLANG_PROFILE_RDTSC
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        std::array<std::uint64_t, cm_opcode_count> m_op_counts;
+        std::array<std::uint64_t, cm_opcode_count> m_op_ticks;
+        std::array<std::uint64_t, cm_opcode_count * cm_opcode_count> m_bigram_counts;
+        std::vector<std::uint64_t> m_func_counts;
+        std::vector<std::uint64_t> m_func_ticks;
+        std::uint64_t m_last_tick;
+        int m_last_func_id;
+        Opcode m_last_op;
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+#include "vm/chunk.hpp"
+
+namespace XLang::VM {
+    class VM;
+
+    /// @brief One frame of a sampled call stack: its function id and the engine pc it was at.
+    struct SampledFrame {
+        int func_id;
+        int pc;
+    };
+
+    /// @brief Collapsed stacks, each `outer;...;inner` frame list mapped to its sample count.
+    using CollapsedStacks = std::map<std::string, std::size_t>;
+
+    /**
+     * @brief Sampling profiler behind `xplice --sample`. A `setitimer(ITIMER_PROF)` timer raises `SIGPROF` at a fixed rate of CPU time, and the handler copies the VM's call stack into storage reserved up front, so no opcode is instrumented.
+     * @note One sampler may run per process. A sample keeps the innermost `cm_max_depth` frames, and samples that no longer fit the reserved storage are only counted as dropped. Hosts without `setitimer` never take samples.
+     */
+    class StackSampler {
+    public:
+        static constexpr int cm_max_depth = 128;
+        static constexpr int cm_default_interval_us = 1000;
+
+        [[nodiscard]] static bool is_supported_host() noexcept;
+
+        StackSampler(const VM& vm, int interval_us = cm_default_interval_us, std::size_t max_frames = 1 << 20);
+        ~StackSampler();
+
+        StackSampler(const StackSampler&) = delete;
+        StackSampler& operator=(const StackSampler&) = delete;
+
+        /// @note Throws `std::runtime_error` when another sampler is already running.
+        void start();
+        void stop() noexcept;
+
+        [[nodiscard]] std::size_t sample_count() const noexcept;
+        [[nodiscard]] std::size_t dropped_count() const noexcept;
+
+        /**
+         * @brief Folds the samples into collapsed stacks for flamegraph tools. Frames read `name:line` through `debug_funcs`, see `FunctionDebugInfo`.
+         * @note Functions without debug info, as in `.xpc` images, show up as `fn#<id>`.
+         */
+        [[nodiscard]] CollapsedStacks collapse(std::span<const FunctionDebugInfo> debug_funcs) const;
+
+    private:
+        static void handle_tick(int signal_id) noexcept;
+
+        /// @note Runs inside the signal handler, so it only writes into the reserved frames.
+        void take_sample() noexcept;
+
+        const VM* m_vm;
+        /// @note Each sample is a header `{-1, depth}` followed by its frames, outermost first.
+        std::vector<SampledFrame> m_frames;
+        std::size_t m_frames_used;
+        std::size_t m_samples_n;
+        std::size_t m_dropped_n;
+        int m_interval_us;
+        bool m_running;
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace XLang::VM {
+    /// @brief Per-VM stack limits. Multi-tenant hosts can shrink them per instance.
+    struct StackConfig {
+        int value_stack_limit = 1 << 22;
+        int call_depth_limit = 1 << 18;
+        /// @note Allocates both stacks as fixed `mmap` regions with a `PROT_NONE` guard page each, so an overflow that slips past the per-call check still faults cleanly. Ignored on hosts without `mmap`.
+        bool guard_pages = false;
+    };
+
+    /// @brief Fixed-size `mmap` region followed by one `PROT_NONE` guard page.
+    class GuardedRegion {
+    public:
+        [[nodiscard]] static bool is_supported_host() noexcept;
+
+        /// @note Throws `std::bad_alloc` when the mapping fails.
+        GuardedRegion(std::size_t count, std::size_t elem_size);
+        ~GuardedRegion();
+
+        GuardedRegion(const GuardedRegion&) = delete;
+        GuardedRegion& operator=(const GuardedRegion&) = delete;
+
+        [[nodiscard]] void* base() const noexcept;
+
+        /// @note Usable bytes plus the guard page, so a stack reserving all of it runs into the guard before ever reallocating.
+        [[nodiscard]] std::size_t mapped_bytes() const noexcept;
+
+        [[nodiscard]] bool guard_contains(const void* addr) const noexcept;
+
+    private:
+        unsigned char* m_base;
+        std::size_t m_usable_bytes;
+        std::size_t m_guard_bytes;
+    };
+
+    /// @brief Hands a `std::vector` its guarded region when there is one, and heap memory otherwise.
+    template <typename T>
+    class StackAllocator {
+    public:
+        using value_type = T;
+
+        StackAllocator() noexcept
+        : m_region {nullptr} {}
+
+        explicit StackAllocator(const GuardedRegion* region) noexcept
+        : m_region {region} {}
+
+        template <typename U>
+        StackAllocator(const StackAllocator<U>& other) noexcept
+        : m_region {other.region()} {}
+
+        [[nodiscard]] T* allocate(std::size_t n) {
+            if (m_region == nullptr) {
+                return std::allocator<T> {}.allocate(n);
+            }
+
+            if (n * sizeof(T) > m_region->mapped_bytes()) {
+                throw std::bad_alloc {};
+            }
+
+            return static_cast<T*>(m_region->base());
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept {
+            if (m_region == nullptr) {
+                std::allocator<T> {}.deallocate(ptr, n);
+            }
+        }
+
+        [[nodiscard]] const GuardedRegion* region() const noexcept {
+            return m_region;
+        }
+
+        friend bool operator==(const StackAllocator& lhs, const StackAllocator& rhs) noexcept {
+            return lhs.m_region == rhs.m_region;
+        }
+
+    private:
+        const GuardedRegion* m_region;
+    };
+
+    enum class GuardHit : int {
+        none,
+        value_stack,
+        call_stack
+    };
+
+    /**
+     * @brief Runs `body(context)` on this thread with a `SIGSEGV` handler that turns a hit on either guard page into a return value.
+     * @note The handler jumps straight out of the faulting store, so the caller may only record the fault and stop: whatever `body` was doing is abandoned. Faults anywhere else go to the previously installed handler.
+     */
+    [[nodiscard]] GuardHit run_with_stack_guards(const GuardedRegion& values, const GuardedRegion& frames, void (*body)(void*), void* context);
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+
 namespace XLang::VM {
     enum class InstructionArity : unsigned char {
         xia_0,
@@ -36,9 +39,110 @@ namespace XLang::VM {
         xop_ret,
         xop_call,
         xop_call_native,
+        xop_add_i32,
+        xop_sub_i32,
+        xop_mul_i32,
+        xop_div_i32,
+        xop_add_f32,
+        xop_sub_f32,
+        xop_mul_f32,
+        xop_div_f32,
+        xop_cmp_eq_i32,
+        xop_cmp_ne_i32,
+        xop_cmp_lt_i32,
+        xop_cmp_gt_i32,
+        xop_cmp_eq_f32,
+        xop_cmp_ne_f32,
+        xop_cmp_lt_f32,
+        xop_cmp_gt_f32,
+        xop_add_i32_store,
+        xop_sub_i32_store,
+        xop_mul_i32_store,
+        xop_add_f32_store,
+        xop_sub_f32_store,
+        xop_mul_f32_store,
+        xop_jump_not_eq_i32,
+        xop_jump_not_ne_i32,
+        xop_jump_not_lt_i32,
+        xop_jump_not_gt_i32,
+        xop_jump_not_eq_f32,
+        xop_jump_not_ne_f32,
+        xop_jump_not_lt_f32,
+        xop_jump_not_gt_f32,
+        xop_push_local,
+        xop_push_arg,
+        xop_push_func,
+        xop_tail_call,
         last
     };
 
+    /// @note Stack height change per opcode, shared by `GraphPass` and the load-time verifier. `CALL` and `CALL_NATIVE` also drop their arguments, and `opcode_clears_frame` marks opcodes that leave the callee's frame.
+    inline constexpr int opcode_clears_frame = -100;
+
+    inline constexpr std::array<int, static_cast<std::size_t>(Opcode::last)> opcode_stack_deltas = {
+        -100,
+        0,
+        -1,
+        1,
+        -1,
+        1,
+        1,
+        0,
+        0,
+        1,
+        0,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        0,
+        -1,
+        -1,
+        -100,
+        1,
+        1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        -1,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        1,
+        1,
+        1,
+        -100
+    };
+
     enum class Errcode : unsigned char {
         xerr_normal,
         xerr_arithmetic,
@@ -54,4 +158,9 @@ namespace XLang::VM {
         xrt_virtual,
         xrt_native
     };
+
+    enum class EngineKind : unsigned char {
+        xek_stack,
+        xek_register
+    };
 }
\ No newline at end of file
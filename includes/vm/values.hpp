@@ -1,16 +1,20 @@
 #pragma once
 
+#include <bit>
+#include <cstdint>
+#include <type_traits>
 #include <variant>
 #include "codegen/steps.hpp"
 
 namespace XLang::VM {
-    enum class ValueTag {
+    enum class ValueTag : unsigned char {
         primitive_null,
         primitive_bool,
         primitive_int,
         primitive_float,
         object_array,
         object_tuple,
+        reference,
         last,
     };
 
@@ -21,41 +25,105 @@ namespace XLang::VM {
     //     int field_id;
     // };
 
+    /**
+     * @brief Tagged 8-byte value. All payloads are at most 32 bits wide, so one machine word holds the payload in its low half, the `ValueTag` in bits 32-39, and a locator's `Region` in bits 40-47. No NaN-boxing is needed since floats are single precision.
+     */
     struct Value {
     public:
         using box_type = std::variant<NullValue, bool, int, float, Codegen::Locator>;
 
-        Value() noexcept;
-        explicit Value(bool b);
-        explicit Value(int i);
-        explicit Value(float f);
-        explicit Value(Codegen::Locator ref);
+        constexpr Value() noexcept
+        : m_bits {pack(ValueTag::primitive_null, 0U)} {}
 
-        [[nodiscard]] ValueTag tag() const noexcept;
-        [[nodiscard]] const box_type& inner_box() const noexcept;
+        constexpr explicit Value(bool b) noexcept
+        : m_bits {pack(ValueTag::primitive_bool, b ? 1U : 0U)} {}
 
-        [[nodiscard]] bool is_boolean() const noexcept;
-        [[nodiscard]] bool is_numeric() const noexcept;
-        [[nodiscard]] bool is_object() const noexcept;
-        [[nodiscard]] bool is_func_reference() const noexcept;
+        constexpr explicit Value(int i) noexcept
+        : m_bits {pack(ValueTag::primitive_int, static_cast<std::uint32_t>(i))} {}
+
+        constexpr explicit Value(float f) noexcept
+        : m_bits {pack(ValueTag::primitive_float, std::bit_cast<std::uint32_t>(f))} {}
+
+        constexpr explicit Value(Codegen::Locator ref) noexcept
+        : m_bits {pack(ValueTag::reference, static_cast<std::uint32_t>(ref.id)) | (static_cast<std::uint64_t>(ref.region) << cm_region_shift)} {}
+
+        [[nodiscard]] constexpr ValueTag tag() const noexcept {
+            return static_cast<ValueTag>((m_bits >> cm_tag_shift) & cm_byte_mask);
+        }
+
+        /// @note Slow path kept for generic code: rebuilds a variant from the tagged word.
+        [[nodiscard]] box_type inner_box() const noexcept;
+
+        [[nodiscard]] constexpr bool as_bool() const noexcept {
+            return (m_bits & 1U) != 0;
+        }
+
+        [[nodiscard]] constexpr int as_int() const noexcept {
+            return static_cast<int>(static_cast<std::uint32_t>(m_bits));
+        }
+
+        [[nodiscard]] constexpr float as_float() const noexcept {
+            return std::bit_cast<float>(static_cast<std::uint32_t>(m_bits));
+        }
+
+        [[nodiscard]] constexpr Codegen::Locator as_locator() const noexcept {
+            return {
+                .region = static_cast<Codegen::Region>((m_bits >> cm_region_shift) & cm_byte_mask),
+                .id = as_int()
+            };
+        }
+
+        [[nodiscard]] constexpr bool is_null() const noexcept {
+            return tag() == ValueTag::primitive_null;
+        }
+
+        [[nodiscard]] constexpr bool is_boolean() const noexcept {
+            return tag() == ValueTag::primitive_bool;
+        }
+
+        [[nodiscard]] constexpr bool is_numeric() const noexcept {
+            const auto value_tag = tag();
+
+            return value_tag == ValueTag::primitive_int || value_tag == ValueTag::primitive_float;
+        }
+
+        [[nodiscard]] constexpr bool is_object() const noexcept {
+            const auto value_tag = tag();
+
+            return value_tag == ValueTag::object_array || value_tag == ValueTag::object_tuple;
+        }
+
+        [[nodiscard]] constexpr bool is_func_reference() const noexcept {
+            return tag() == ValueTag::reference && as_locator().region == Codegen::Region::routines;
+        }
 
         // [[nodiscard]] FieldReference access_property(int id) noexcept;
         // [[nodiscard]] FieldReference access_property(std::string_view name) noexcept;
 
-        [[nodiscard]] Value add(const Value& rhs) const;
-        [[nodiscard]] Value subtract(const Value& rhs) const;
-        [[nodiscard]] Value multiply(const Value& rhs) const;
-        [[nodiscard]] Value divide(const Value& rhs) const;
-        [[nodiscard]] Value compare_eq(const Value& rhs) const;
-        [[nodiscard]] Value compare_ne(const Value& rhs) const;
-        [[nodiscard]] Value compare_lt(const Value& rhs) const;
-        [[nodiscard]] Value compare_gt(const Value& rhs) const;
-        [[nodiscard]] Value logical_and(const Value& rhs) const;
-        [[nodiscard]] Value logical_or(const Value& rhs) const;
+        /// @note Generic operations never throw: invalid operands or a zero divisor yield a null `Value`, which no valid result can be.
+        [[nodiscard]] Value add(const Value& rhs) const noexcept;
+        [[nodiscard]] Value subtract(const Value& rhs) const noexcept;
+        [[nodiscard]] Value multiply(const Value& rhs) const noexcept;
+        [[nodiscard]] Value divide(const Value& rhs) const noexcept;
+        [[nodiscard]] Value compare_eq(const Value& rhs) const noexcept;
+        [[nodiscard]] Value compare_ne(const Value& rhs) const noexcept;
+        [[nodiscard]] Value compare_lt(const Value& rhs) const noexcept;
+        [[nodiscard]] Value compare_gt(const Value& rhs) const noexcept;
+        [[nodiscard]] Value logical_and(const Value& rhs) const noexcept;
+        [[nodiscard]] Value logical_or(const Value& rhs) const noexcept;
 
     private:
-        box_type m_data;
-        ValueTag m_tag;
+        static constexpr int cm_tag_shift = 32;
+        static constexpr int cm_region_shift = 40;
+        static constexpr std::uint64_t cm_byte_mask = 0xff;
 
+        [[nodiscard]] static constexpr std::uint64_t pack(ValueTag tag, std::uint32_t payload) noexcept {
+            return (static_cast<std::uint64_t>(tag) << cm_tag_shift) | payload;
+        }
+
+        std::uint64_t m_bits;
     };
-}
\ No newline at end of file
+
+    static_assert(sizeof(Value) == 8, "Value must stay register sized.");
+    static_assert(std::is_trivially_destructible_v<Value>, "Value must stay trivially destructible so frames can be dropped by truncation.");
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <span>
+#include "vm/chunk.hpp"
+
+namespace XLang::VM {
+    /**
+     * @brief Checks a program's decoded functions once at load time, so dispatch can run them without per-instruction safety checks. Throws `std::runtime_error` naming the function and instruction of the first violation.
+     * @note Checks operand regions, the ids of constants, arguments, functions, natives, and temporaries against their bounds, stack underflow along every path, using `opcode_stack_deltas` and the lowest height wherever control flow merges, and that no path runs off the end of a function. The highest height on any path must stay within the function's `max_stack_depth`, and no loop may end higher than it began. Every call of a function must pass the same argument count, and the entry function takes none. Native ids must fall below `native_count`, the number of natives the host registers.
+     */
+    void verify_program(std::span<const InstructionStore> funcs, std::span<const ChunkView> views, int entry_id, int native_count);
+}
@@ -1,92 +1,210 @@
 #pragma once
 
 #include <array>
-#include <unordered_map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 #include "vm/tags.hpp"
 #include "vm/values.hpp"
 #include "vm/chunk.hpp"
+#include "vm/jit.hpp"
+#include "vm/profiler.hpp"
+#include "vm/sampler.hpp"
+#include "vm/stacks.hpp"
+#include "vm/xpc.hpp"
 
 namespace XLang::VM {
     struct CallFrame {
-        ArgStore args;
+        /// @note Resolved once per call so fetching never looks up the callee's chunk.
+        const Instruction* code;
+        const Value* constants;
         int callee_id;
         int callee_pos;
-        /// @todo use this field based on README plans.
+        /// @note Index of the callee reference. Argument N sits at `callee_frame_base - 1 - N`, as calls push arguments in reverse.
         int callee_frame_base;
+        /// @note Absolute value-stack index that receives this frame's return value. Returning truncates the value stack here.
+        int result_slot;
+    };
+
+    /// @brief Describes the first runtime error of a run. Handlers record it instead of throwing, and the dispatch loop stops at its next branch point.
+    struct FaultInfo {
+        const char* message = nullptr;
+        Errcode code = Errcode::xerr_normal;
+        /// @note Function and instruction index that faulted, or -1 when no fault was raised.
+        int func_id = -1;
+        int pc = -1;
+        int frame_depth = -1;
     };
 
     class VM {
     public:
-        VM(XpliceProgram prgm) noexcept;
+        /**
+         * @note `use_jit` compiles hot functions with `TemplateJit` on hosts that support it, and is ignored elsewhere.
+         * @note Both stacks are reserved to the limits in `stack_config` once at load, so pushes never reallocate. Calls fault instead of growing past them.
+         * @note `native_count` is how many natives the host will register with `add_native_function`. Loading rejects code that calls a native id at or past it.
+         */
+        VM(XpliceProgram prgm, EngineKind engine = EngineKind::xek_stack, bool use_jit = false, StackConfig stack_config = {}, int native_count = 0);
+
+        /// @note Runs straight from a loaded `.xpc` image: constants are read in place and bytecode is decoded from the mapping without copying it into chunks.
+        VM(XpcImage image, EngineKind engine = EngineKind::xek_stack, bool use_jit = false, StackConfig stack_config = {}, int native_count = 0);
 
         [[nodiscard]] Errcode run();
-        [[nodiscard]] Errcode invoke_native_func(const NativeFunction& func, const ArgStore& args);
+        [[nodiscard]] Errcode invoke_native_func(const NativeFunction& func, ArgView args);
 
         void add_native_function(int native_id, const NativeFunction& func) noexcept;
 
+        [[nodiscard]] const FaultInfo& fault() const noexcept;
+
+        /// @note Switches `run` to engines instantiated with `OpcodeProfiler`. Threaded builds profile on the `switch` engine, as labels-as-values dispatch has no single hook point.
+        void enable_profiling();
+
+        /// @note Null unless profiling was enabled.
+        [[nodiscard]] const OpcodeProfiler* profiler() const noexcept;
+
+        /// @note Async-signal-safe for `StackSampler`: copies the innermost `out.size()` frames of the live call stack, outermost first, and returns how many it copied. Callers report the pc of their pending call.
+        [[nodiscard]] std::size_t snapshot_call_stack(std::span<SampledFrame> out) const noexcept;
+
+        /// @note Function names and line tables of the loaded program. Empty for `.xpc` images.
+        [[nodiscard]] std::span<const FunctionDebugInfo> debug_info() const noexcept;
+
+        /// @note Maps an engine pc back to the stack-code index that `LineEntry` tables use. Only register-engine pcs differ.
+        [[nodiscard]] int stack_pc(int func_id, int pc) const noexcept;
+
         const Value& peek_stack_top() const noexcept;
+        /// @note Natives must push exactly one result, as the VM only reserves one slot past their arguments.
         void push_from_native(Value temp) noexcept;
 
-        void handle_halt();
-        void handle_replace(const Codegen::Locator& arg);
-        void handle_push(const Codegen::Locator& arg);
-        void handle_pop(const Codegen::Locator& arg);
-        void handle_peek(const Codegen::Locator& arg);
+        void handle_halt() noexcept;
+        void handle_replace(const Codegen::Locator& arg) noexcept;
+        void handle_push(const Codegen::Locator& arg) noexcept;
+        void handle_pop(const Codegen::Locator& arg) noexcept;
+        void handle_peek(const Codegen::Locator& arg) noexcept;
+
+        /// @note Region-specific pushes picked by `EmitCodePass`, so none of them switch on the locator's region.
+        void handle_push_local(const Codegen::Locator& arg) noexcept;
+        void handle_push_arg(const Codegen::Locator& arg) noexcept;
+        void handle_push_func(const Codegen::Locator& arg) noexcept;
 
         /* NOTE: implement make_array, make_tuple, access_field... */
 
-        void handle_load_const(const Codegen::Locator& arg);
-        void handle_negate();
-        void handle_arithmetic(Opcode op);
-        void handle_compare(Opcode op);
-        void handle_logical(Opcode op);
-        void handle_jump_not_if(const Codegen::Locator& arg);
-        void handle_return(const Codegen::Locator& arg);
-        void handle_call(const Codegen::Locator& local_func_id, int argc);
-        void handle_native_call(int module_id, int native_id, int argc);
+        void handle_load_const(const Codegen::Locator& arg) noexcept;
+        void handle_negate() noexcept;
+        void handle_arithmetic(Opcode op) noexcept;
+        void handle_compare(Opcode op) noexcept;
+        void handle_logical(Opcode op) noexcept;
+
+        /// @note Typed handlers skip all tag checks, as codegen only emits them for operands proven to share a type.
+        template <typename Operand, typename Operation>
+        void handle_typed_binary(Operation operation) noexcept;
+        void handle_divide_i32() noexcept;
+        void handle_divide_f32() noexcept;
+
+        /// @note Superinstruction handlers read both operands in place instead of through the value stack.
+        template <typename Operand, typename Operation>
+        void handle_fused_store(const Codegen::Locator& dst, const Codegen::Locator& lhs, const Codegen::Locator& rhs, Operation operation) noexcept;
+        template <typename Operand, typename Operation>
+        void handle_fused_branch(const Codegen::Locator& target, const Codegen::Locator& lhs, const Codegen::Locator& rhs, Operation operation, int next_pos) noexcept;
+
+        void handle_jump_not_if(const Codegen::Locator& arg, int next_pos) noexcept;
+        void handle_return(const Codegen::Locator& arg) noexcept;
+        void handle_call(const Codegen::Locator& local_func_id, int argc, int ret_pos) noexcept;
+        /// @note Replaces the current frame with the callee's, so a chain of tail calls runs in constant stack space.
+        void handle_tail_call(const Codegen::Locator& local_func_id, int argc) noexcept;
+        void handle_native_call(int module_id, int native_id, int argc) noexcept;
+
+        /// @note Register engine handlers take three-address args, see `lower_to_registers`.
+        void handle_reg_generic(Opcode op, const std::array<Codegen::Locator, 3>& args) noexcept;
+        void handle_reg_negate(const std::array<Codegen::Locator, 3>& args) noexcept;
+        template <typename Operand, typename Operation>
+        void handle_reg_typed(const std::array<Codegen::Locator, 3>& args, Operation operation) noexcept;
+        template <typename Operand>
+        void handle_reg_divide(const std::array<Codegen::Locator, 3>& args) noexcept;
+        template <typename Operand, typename Operation>
+        void handle_reg_branch(const std::array<Codegen::Locator, 3>& args, Operation operation, int next_pos) noexcept;
+        void handle_reg_jump_not_if(const std::array<Codegen::Locator, 3>& args, int next_pos) noexcept;
+        void handle_reg_return(const Codegen::Locator& arg) noexcept;
+        void handle_reg_call(const std::array<Codegen::Locator, 3>& args, int ret_pos) noexcept;
+        void handle_reg_tail_call(const std::array<Codegen::Locator, 3>& args) noexcept;
+        void handle_reg_native_call(const std::array<Codegen::Locator, 3>& args) noexcept;
 
     private:
-        static constexpr std::array<int, static_cast<std::size_t>(Opcode::last)> opcode_arity = {
-            0,
-            0,
-            1,
-            1,
-            1,
-            1,
-            1,
-            1,
-            1,
-            2,
-            0,
-            0,
-            0,
-            0,
-            0,
-            0,
-            0,
-            0,
-            0,
-            0,
-            0,
-            1,
-            1,
-            1,
-            1,
-            2,
-            3
-        };
+        /// @note Shared setup of both constructors once `m_func_views` is filled: decodes every function and pushes the entry frame.
+        void load_functions(int entry_id, bool use_jit, int native_count);
 
         [[nodiscard]] const CallFrame& current_frame() const noexcept;
         [[nodiscard]] bool is_done() const noexcept;
+        [[nodiscard]] bool has_fault() const noexcept;
 
-        [[nodiscard]] Opcode decode_opcode() const noexcept;
-        [[nodiscard]] Codegen::Locator decode_arg(int arg_num) const noexcept;
+        /// @note Records a fault and lets the handler finish with placeholder results, so the stack stays balanced until the next branch point.
+        void raise_fault(Errcode code, const char* message) noexcept;
 
+        void refresh_active_frame() noexcept;
+
+        /// @note The one overflow check per call: records a fault when the callee's frame would not fit in either stack.
+        [[nodiscard]] bool has_room_for_frame(int callee_id, int callee_base, bool adds_frame) noexcept;
+
+        /// @note Counts calls to `callee_id` and runs it as compiled code once hot. Returns nothing when the call must be interpreted.
+        [[nodiscard]] std::optional<Value> try_jit_call(int callee_id, const Value* args_begin, int argc) noexcept;
+
+        [[nodiscard]] const Instruction& fetch_instruction() const noexcept;
+
+        /// @note Runs a native over the `argc` values starting at `args_begin`, which stay on the value stack. Faults with `xerr_access` when `native_id` was never registered.
+        [[nodiscard]] Errcode invoke_native_in_place(int native_id, int args_begin, int argc) noexcept;
+
+        /// @note Only constant, local, and argument locators are valid here, as `EmitCodePass` fuses nothing else.
+        [[nodiscard]] const Value& read_operand(const Codegen::Locator& arg) const noexcept;
+
+        [[nodiscard]] Value& register_at(const Codegen::Locator& reg) noexcept;
+        [[nodiscard]] const Value& read_register_operand(const Codegen::Locator& arg) const noexcept;
+
+        /// @note Runs the selected engine until the program ends or faults.
+        void dispatch();
+
+        /// @note Portable engine: one `switch` per instruction. `Profiler` is `NoProfiling` or `OpcodeProfiler`.
+        template <typename Profiler>
+        void dispatch_switch(Profiler& profiler);
+
+        /// @note Direct-threaded engine using labels-as-values, only built when `XLANG_THREADED_DISPATCH` is on.
+        void dispatch_threaded();
+
+        /// @note Register engine over the lowered three-address code, selected by `EngineKind::xek_register`.
+        template <typename Profiler>
+        void dispatch_registers(Profiler& profiler);
+
+        /// @note Only one of the program or the image owns the code, depending on the constructor used.
         XpliceProgram m_program_funcs;
-        std::unordered_map<int, NativeFunction> m_native_funcs;
-        std::vector<CallFrame> m_frames;
-        std::vector<Value> m_values;
+        XpcImage m_image;
+        /// @note Constants and bytecode per function id, over whichever of the two owns them.
+        std::vector<ChunkView> m_func_views;
+        std::vector<InstructionStore> m_decoded_funcs;
+        /// @note Frame register counts per function, only filled for the register engine.
+        std::vector<int> m_register_counts;
+        /// @note Stack-code index of every register instruction per function, only filled for the register engine.
+        std::vector<std::vector<int>> m_stack_pcs;
+        /// @note Value-stack slots a call needs above its frame base per function: the max stack depth for the stack engine, or the register count.
+        std::vector<int> m_frame_sizes;
+        std::vector<NativeFunction> m_native_funcs;
+        /// @note Only set up when the JIT is on.
+        std::unique_ptr<TemplateJit> m_jit;
+        std::unique_ptr<OpcodeProfiler> m_profiler;
+        std::vector<int> m_call_counts;
+        StackConfig m_stack_config;
+        /// @note Only mapped in guard-page mode, and kept behind pointers because the stacks' allocators refer to them.
+        std::unique_ptr<GuardedRegion> m_frame_region;
+        std::unique_ptr<GuardedRegion> m_value_region;
+        std::vector<CallFrame, StackAllocator<CallFrame>> m_frames;
+        std::vector<Value, StackAllocator<Value>> m_values;
+
+        /// @note Mirrors `code`, `constants`, and `callee_frame_base` of the active frame.
+        const Instruction* m_code;
+        const Value* m_consts;
+        int m_frame_base;
+
+        FaultInfo m_fault;
+
         int m_iptr;
         Errcode m_exit_status;
+        EngineKind m_engine;
     };
 }
\ No newline at end of file
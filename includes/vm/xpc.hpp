@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "vm/chunk.hpp"
+
+namespace XLang::VM {
+    /**
+     * @brief Versioned binary image of a compiled program, written by `xplice --compile`. All fields are little-endian:
+     *  1. Header: magic `XPC\0`, u16 format version, u16 opcode count, u32 function count, i32 entry function id, and u64 file size.
+     *  2. Function table: per function, u32 offset and count of its constants, u32 offset and size of its bytecode, then its u32 max stack depth.
+     *  3. Pools: every function's constants as raw 8-byte `Value` words aligned to 8 bytes, each followed by its bytecode.
+     */
+    struct XpcFormat {
+        static constexpr std::uint16_t cm_version = 2;
+        static constexpr std::size_t cm_header_size = 24;
+        static constexpr std::size_t cm_table_entry_size = 20;
+    };
+
+    /**
+     * @brief Read-only `.xpc` image, mapped into memory with `mmap` where available and read into a heap buffer elsewhere.
+     * @note The VM reads constants in place and decodes bytecode straight from the image, so it must outlive any VM running it.
+     */
+    class XpcImage {
+    public:
+        XpcImage() noexcept;
+
+        /// @note Throws `std::runtime_error` when the file is missing, was written by another format or opcode set, has a table pointing outside of it, or records a max stack depth past the default value stack.
+        explicit XpcImage(const char* path);
+
+        ~XpcImage();
+
+        XpcImage(const XpcImage&) = delete;
+        XpcImage& operator=(const XpcImage&) = delete;
+
+        XpcImage(XpcImage&& other) noexcept;
+        XpcImage& operator=(XpcImage&& other) noexcept;
+
+        /// @note Views are indexed by function id.
+        [[nodiscard]] const std::vector<ChunkView>& functions() const noexcept;
+
+        [[nodiscard]] int entry_func_id() const noexcept;
+
+    private:
+        void validate_and_index();
+        void release() noexcept;
+
+        const RuntimeByte* m_data;
+        std::size_t m_size;
+        bool m_mapped;
+        /// @note Backs the image when it could not be mapped. Words keep constants 8-byte aligned.
+        std::vector<std::uint64_t> m_owned_words;
+        std::vector<ChunkView> m_funcs;
+        int m_entry_func_id;
+    };
+
+    /// @brief Serializes a program into the `.xpc` format described by `XpcFormat`.
+    void write_xpc(const XpliceProgram& prgm, std::ostream& out);
+}
@@ -0,0 +1,15 @@
+# Hashes every compiler and VM source into one build id, so compile cache keys change whenever bytecode output might...
+# Expects XLANG_INC_DIR, XLANG_SRC_DIR, XLANG_ID_TEMPLATE, and XLANG_ID_OUTPUT.
+file(GLOB_RECURSE xlang_id_sources "${XLANG_INC_DIR}/*.hpp" "${XLANG_SRC_DIR}/*.cpp")
+
+set(xlang_id_text "")
+
+foreach (xlang_id_source IN LISTS xlang_id_sources)
+    file(SHA256 "${xlang_id_source}" xlang_id_source_hash)
+    string(APPEND xlang_id_text "${xlang_id_source_hash}")
+endforeach ()
+
+string(SHA256 xlang_build_id "${xlang_id_text}")
+string(SUBSTRING "${xlang_build_id}" 0 16 xlang_build_id)
+
+configure_file("${XLANG_ID_TEMPLATE}" "${XLANG_ID_OUTPUT}" @ONLY)
@@ -4,10 +4,12 @@
 
 namespace XLang::Codegen {
     void Disassembler::operator()(const VM::XpliceProgram& program) {
-        const auto& [program_chunks, program_main_id] = program;
+        const auto& [program_chunks, program_main_id, program_debug_funcs] = program;
 
-        for (const auto& [func_id, func_chunk] : program_chunks) {
-            print_chunk(func_id, program_main_id, func_chunk.view_code());
+        const auto chunk_count = static_cast<int>(program_chunks.size());
+
+        for (auto func_id = 0; func_id < chunk_count; ++func_id) {
+            print_chunk(func_id, program_main_id, program_chunks[func_id].view_code());
         }
     }
 
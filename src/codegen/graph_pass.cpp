@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <utility>
 #include "syntax/exprs.hpp"
 #include "codegen/graph_pass.hpp"
@@ -145,10 +146,26 @@ namespace XLang::Codegen {
         return m_global_func_map.at(name);
     }
 
+    Semantics::TypeTag GraphPass::lookup_operand_type(const Syntax::Binary& expr) const noexcept {
+        if (!m_operand_hints_p) {
+            return Semantics::TypeTag::x_type_unknown;
+        }
+
+        if (auto hint_it = m_operand_hints_p->find(&expr); hint_it != m_operand_hints_p->end()) {
+            return hint_it->second;
+        }
+
+        return Semantics::TypeTag::x_type_unknown;
+    }
+
     void GraphPass::commit_current_consts() {
         m_func_consts.emplace_back(m_const_map);
     }
 
+    void GraphPass::commit_max_stack_score() {
+        m_func_max_stack_scores.push_back(m_max_stack_score);
+    }
+
     void GraphPass::update_stack_score_delta(const StepUnion& step) {
         /// @note This accounts for any calls that will pop their various args...
         auto adjusted_pop_n = 0;
@@ -177,11 +194,13 @@ namespace XLang::Codegen {
 
         const auto opcode_id = static_cast<unsigned int>(step_op);
 
-        if (const auto delta = m_op_stack_deltas[opcode_id]; delta != -100) {
+        if (const auto delta = VM::opcode_stack_deltas[opcode_id]; delta != VM::opcode_clears_frame) {
             m_stack_score += delta;
         } else {
             m_stack_score = 0;
         }
+
+        m_max_stack_score = std::max(m_max_stack_score, m_stack_score);
     }
 
     void GraphPass::leave_record() {
@@ -189,6 +208,7 @@ namespace XLang::Codegen {
         m_current_name_map.clear();
         m_current_params_map.clear();
         m_stack_score = 0;
+        m_max_stack_score = 0;
     }
 
     void GraphPass::place_step(StepUnion step) {
@@ -201,7 +221,10 @@ namespace XLang::Codegen {
         auto& working_node = m_nodes.back();
 
         if (std::holds_alternative<Unit>(working_node)) {
-            std::get<Unit>(working_node).steps.emplace_back(std::move(step));
+            auto& working_unit = std::get<Unit>(working_node);
+
+            working_unit.steps.emplace_back(std::move(step));
+            working_unit.step_lines.push_back(m_current_line);
         }
     }
 
@@ -291,7 +314,19 @@ namespace XLang::Codegen {
     }
 
     std::any GraphPass::help_gen_arithmetic(OpLeaning op_lean, const Syntax::Binary& expr) {
-        auto get_arith_opcode = [](Semantics::OpTag op) {
+        auto get_arith_opcode = [](Semantics::OpTag op, Semantics::TypeTag operand_type) {
+            if (operand_type == Semantics::TypeTag::x_type_int) {
+                if (op == Semantics::OpTag::add) return VM::Opcode::xop_add_i32;
+                else if (op == Semantics::OpTag::subtract) return VM::Opcode::xop_sub_i32;
+                else if (op == Semantics::OpTag::multiply) return VM::Opcode::xop_mul_i32;
+                else if (op == Semantics::OpTag::divide) return VM::Opcode::xop_div_i32;
+            } else if (operand_type == Semantics::TypeTag::x_type_float) {
+                if (op == Semantics::OpTag::add) return VM::Opcode::xop_add_f32;
+                else if (op == Semantics::OpTag::subtract) return VM::Opcode::xop_sub_f32;
+                else if (op == Semantics::OpTag::multiply) return VM::Opcode::xop_mul_f32;
+                else if (op == Semantics::OpTag::divide) return VM::Opcode::xop_div_f32;
+            }
+
             if (op == Semantics::OpTag::add) return VM::Opcode::xop_add;
             else if (op == Semantics::OpTag::subtract) return VM::Opcode::xop_sub;
             else if (op == Semantics::OpTag::multiply) return VM::Opcode::xop_mul;
@@ -299,7 +334,7 @@ namespace XLang::Codegen {
             return VM::Opcode::xop_noop;
         };
 
-        const auto opcode = get_arith_opcode(expr.op);
+        const auto opcode = get_arith_opcode(expr.op, lookup_operand_type(expr));
 
         if (opcode == VM::Opcode::xop_noop) {
             throw std::logic_error {"Invalid operator for arithmetic codegen!\n"};
@@ -321,7 +356,19 @@ namespace XLang::Codegen {
     }
 
     std::any GraphPass::help_gen_compare(OpLeaning op_lean, const Syntax::Binary& expr) {
-        auto get_comp_opcode = [](Semantics::OpTag op) {
+        auto get_comp_opcode = [](Semantics::OpTag op, Semantics::TypeTag operand_type) {
+            if (operand_type == Semantics::TypeTag::x_type_int) {
+                if (op == Semantics::OpTag::cmp_equ) return VM::Opcode::xop_cmp_eq_i32;
+                else if (op == Semantics::OpTag::cmp_neq) return VM::Opcode::xop_cmp_ne_i32;
+                else if (op == Semantics::OpTag::cmp_gt) return VM::Opcode::xop_cmp_gt_i32;
+                else if (op == Semantics::OpTag::cmp_lt) return VM::Opcode::xop_cmp_lt_i32;
+            } else if (operand_type == Semantics::TypeTag::x_type_float) {
+                if (op == Semantics::OpTag::cmp_equ) return VM::Opcode::xop_cmp_eq_f32;
+                else if (op == Semantics::OpTag::cmp_neq) return VM::Opcode::xop_cmp_ne_f32;
+                else if (op == Semantics::OpTag::cmp_gt) return VM::Opcode::xop_cmp_gt_f32;
+                else if (op == Semantics::OpTag::cmp_lt) return VM::Opcode::xop_cmp_lt_f32;
+            }
+
             if (op == Semantics::OpTag::cmp_equ) return VM::Opcode::xop_cmp_eq;
             else if (op == Semantics::OpTag::cmp_neq) return VM::Opcode::xop_cmp_ne;
             else if (op == Semantics::OpTag::cmp_gt) return VM::Opcode::xop_cmp_gt;
@@ -329,7 +376,7 @@ namespace XLang::Codegen {
             return VM::Opcode::xop_noop;
         };
 
-        const auto opcode = get_comp_opcode(expr.op);
+        const auto opcode = get_comp_opcode(expr.op, lookup_operand_type(expr));
 
         if (op_lean == OpLeaning::lean_left) {
             expr.left->accept_visitor(*this);
@@ -408,8 +455,8 @@ namespace XLang::Codegen {
     }
 
 
-    GraphPass::GraphPass(std::string_view old_source, const Semantics::NativeHints* native_hints_p_) noexcept
-    : m_heap_all {}, m_current_name_map {}, m_current_params_map {}, m_global_func_map {}, m_const_map {}, m_func_consts {}, m_nodes {}, m_graph {std::make_unique<FlowGraph>()}, m_result {new FlowStore {}}, m_old_src {old_source}, m_native_hints_p {native_hints_p_}, m_stack_score {0}, m_main_func_idx {dud_offset} {}
+    GraphPass::GraphPass(std::string_view old_source, const Semantics::NativeHints* native_hints_p_, const Semantics::OperandHints* operand_hints_p_) noexcept
+    : m_heap_all {}, m_current_name_map {}, m_current_params_map {}, m_global_func_map {}, m_const_map {}, m_func_consts {}, m_func_max_stack_scores {}, m_nodes {}, m_graph {std::make_unique<FlowGraph>()}, m_result {new FlowStore {}}, m_old_src {old_source}, m_native_hints_p {native_hints_p_}, m_operand_hints_p {operand_hints_p_}, m_stack_score {0}, m_max_stack_score {0}, m_current_line {0}, m_main_func_idx {dud_offset} {}
 
     std::any GraphPass::visit_literal(const Syntax::Literal& expr) {
         auto record_const_primitive = [this](Semantics::TypeTag tag, const Frontend::Token& primitive_token) {
@@ -469,6 +516,8 @@ namespace XLang::Codegen {
             };
         };
 
+        m_current_line = expr.token.line;
+
         auto primitive_info = expr.type_tagging();
         const auto primitive_tag = (std::holds_alternative<Semantics::PrimitiveType>(primitive_info))
             ? std::get<Semantics::PrimitiveType>(primitive_info).item_tag
@@ -546,13 +595,18 @@ namespace XLang::Codegen {
         throw std::logic_error {"Invalid / unsupported binary operation for codegen!\n"};
     }
 
+    void GraphPass::help_gen_call_args(const Syntax::Call& expr) {
+        /// @note Arguments go last-to-first, so argument 0 ends up nearest the callee's frame base.
+        for (auto arg_iter = static_cast<int>(expr.args.size()) - 1; arg_iter >= 0; --arg_iter) {
+            expr.args[arg_iter]->accept_visitor(*this);
+        }
+    }
+
     std::any GraphPass::visit_call(const Syntax::Call& expr) {
         const auto func_locator = lookup_callable_name(expr.func_name);
         auto args_n = static_cast<int>(expr.args.size());
 
-        for (auto arg_iter = args_n - 1; arg_iter >= 0; --arg_iter) {
-            expr.args[arg_iter]->accept_visitor(*this);
-        }
+        help_gen_call_args(expr);
 
         if (func_locator.region == Region::routines) {
             place_step(BinaryStep {
@@ -594,6 +648,8 @@ namespace XLang::Codegen {
     }
 
     std::any GraphPass::visit_variable_decl(const Syntax::VariableDecl& stmt) {
+        m_current_line = stmt.name.line;
+
         const auto var_init_box = stmt.init_expr->accept_visitor(*this);
         auto var_name = Frontend::peek_lexeme(stmt.name, m_old_src);
         auto var_init_locator = dud_locator;
@@ -617,6 +673,8 @@ namespace XLang::Codegen {
 
         const auto func_id = next_func_id();
 
+        m_current_line = stmt.name.line;
+
         /// @note Mark which compiled routine is the main one, as it's invoked by the VM.
         if (func_name == "main") {
             m_main_func_idx = func_id;
@@ -629,6 +687,7 @@ namespace XLang::Codegen {
 
         place_node(Unit {
             .steps = {},
+            .step_lines = {},
             .next = dud_offset
         });
 
@@ -645,6 +704,7 @@ namespace XLang::Codegen {
         stmt.body->accept_visitor(*this);
 
         commit_current_consts();
+        commit_max_stack_score();
         leave_record();
 
         return {};
@@ -666,6 +726,24 @@ namespace XLang::Codegen {
     }
 
     std::any GraphPass::visit_return(const Syntax::Return& stmt) {
+        /// @note Returning a direct call to a procedure becomes one `tail_call`, which reuses the caller's frame instead of stacking a new one.
+        if (const auto* tail_call = dynamic_cast<const Syntax::Call*>(stmt.result_expr.get()); tail_call != nullptr) {
+            if (const auto func_locator = lookup_callable_name(tail_call->func_name); func_locator.region == Region::routines) {
+                help_gen_call_args(*tail_call);
+
+                place_step(BinaryStep {
+                    .op = VM::Opcode::xop_tail_call,
+                    .arg_0 = func_locator,
+                    .arg_1 = Locator {
+                        .region = Region::none,
+                        .id = static_cast<int>(tail_call->args.size())
+                    }
+                });
+
+                return {};
+            }
+        }
+
         auto result_box = stmt.result_expr->accept_visitor(*this);
 
         if (!result_box.has_value()) {
@@ -700,6 +778,7 @@ namespace XLang::Codegen {
 
         place_node(Unit {
             .steps = {},
+            .step_lines = {},
             .next = dud_offset
         });
         stmt.truthy_body->accept_visitor(*this);
@@ -711,6 +790,7 @@ namespace XLang::Codegen {
         if (stmt.falsy_body) {
             place_node(Unit {
                 .steps = {},
+                .step_lines = {},
                 .next = dud_offset
             });
             stmt.falsy_body->accept_visitor(*this);
@@ -721,6 +801,7 @@ namespace XLang::Codegen {
 
         place_node(Unit {
             .steps = {},
+            .step_lines = {},
             .next = dud_offset
         });
 
@@ -736,6 +817,7 @@ namespace XLang::Codegen {
 
         place_node(Unit {
             .steps = {},
+            .step_lines = {},
             .next = check_juncture_id
         });
         stmt.test->accept_visitor(*this);
@@ -754,6 +836,7 @@ namespace XLang::Codegen {
         // 3. Place body node to generate, but this also needs its next link to exit the enclosing loop.
         place_node(Unit {
             .steps = {},
+            .step_lines = {},
             .next = dud_offset
         });
         stmt.body->accept_visitor(*this);
@@ -771,6 +854,7 @@ namespace XLang::Codegen {
 
         place_node(Unit {
             .steps = {},
+            .step_lines = {},
             .next = dud_offset
         });
 
@@ -787,8 +871,16 @@ namespace XLang::Codegen {
             }
         }
 
+        std::vector<std::string_view> func_names (m_global_func_map.size());
+
+        for (const auto& [func_name, func_locator] : m_global_func_map) {
+            func_names[func_locator.id] = func_name;
+        }
+
         return {
             .const_chunks = std::move(m_func_consts),
+            .max_stack_depths = std::move(m_func_max_stack_scores),
+            .func_names = std::move(func_names),
             .func_cfgs = std::move(m_result),
             .main_func_id = m_main_func_idx
         };
@@ -31,7 +31,41 @@ namespace XLang::Codegen {
         "jump_not_if",
         "ret",
         "call",
-        "call_native"
+        "call_native",
+        "add_i32",
+        "sub_i32",
+        "mul_i32",
+        "div_i32",
+        "add_f32",
+        "sub_f32",
+        "mul_f32",
+        "div_f32",
+        "cmp_eq_i32",
+        "cmp_ne_i32",
+        "cmp_lt_i32",
+        "cmp_gt_i32",
+        "cmp_eq_f32",
+        "cmp_ne_f32",
+        "cmp_lt_f32",
+        "cmp_gt_f32",
+        "add_i32_store",
+        "sub_i32_store",
+        "mul_i32_store",
+        "add_f32_store",
+        "sub_f32_store",
+        "mul_f32_store",
+        "jump_not_eq_i32",
+        "jump_not_ne_i32",
+        "jump_not_lt_i32",
+        "jump_not_gt_i32",
+        "jump_not_eq_f32",
+        "jump_not_ne_f32",
+        "jump_not_lt_f32",
+        "jump_not_gt_f32",
+        "push_local",
+        "push_arg",
+        "push_func",
+        "tail_call"
     };
 
     static constexpr std::array<std::string_view, static_cast<std::size_t>(Region::last)> region_names = {
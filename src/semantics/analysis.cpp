@@ -149,7 +149,7 @@ namespace XLang::Semantics {
     }
 
     SemanticsPass::SemanticsPass(std::string_view source_)
-    : m_native_hints {}, m_scopes {}, m_location {}, m_source {source_} {}
+    : m_native_hints {}, m_operand_hints {}, m_scopes {}, m_location {}, m_source {source_} {}
 
     SemanticResult SemanticsPass::operator()(const std::vector<Syntax::StmtPtr>& ast_decls) {
         enter_scope(); // begin processing global scope
@@ -165,8 +165,9 @@ namespace XLang::Semantics {
         leave_scope(); // end processing of global scope
 
         return {
+            .native_hints = std::move(m_native_hints),
             .errors = std::move(m_result),
-            .native_hints = std::move(m_native_hints)
+            .operand_hints = std::move(m_operand_hints)
         };
     }
 
@@ -275,6 +276,8 @@ namespace XLang::Semantics {
             return {};
         }
 
+        record_operand_hint(expr, unpack_underlying_type_tag(lhs_info), unpack_underlying_type_tag(rhs_info));
+
         /// 1. Handle access expr. case...
         if (const auto lhs_type_num = lhs_info.index(); lhs_type_num >= 2) {
             return checked_info;
@@ -614,6 +617,8 @@ namespace XLang::Semantics {
             return {};
         }
 
+        stmt.body->accept_visitor(*this);
+
         return {};
     }
 
@@ -675,6 +680,21 @@ namespace XLang::Semantics {
         };
     }
 
+    void SemanticsPass::record_operand_hint(const Syntax::Binary& expr, TypeTag lhs_type, TypeTag rhs_type) {
+        const auto expr_op = expr.op;
+
+        if (expr_op < OpTag::multiply || expr_op > OpTag::cmp_gt) {
+            return;
+        }
+
+        /// @note Mixed or unresolved operands keep the generic opcodes, which check tags at runtime.
+        if (lhs_type != rhs_type || (lhs_type != TypeTag::x_type_int && lhs_type != TypeTag::x_type_float)) {
+            return;
+        }
+
+        m_operand_hints[&expr] = lhs_type;
+    }
+
     TypeInfo SemanticsPass::resolve_type_from(std::string_view name) {
         if (m_native_hints.contains(name)) {
             return m_native_hints.at(name).signature_type;
@@ -0,0 +1,110 @@
+#include "syntax/node_counter.hpp"
+
+namespace XLang::Syntax {
+    NodeCounter::NodeCounter() noexcept
+    : m_count {0} {}
+
+    std::any NodeCounter::visit_literal([[maybe_unused]] const Literal& expr) {
+        ++m_count;
+
+        return {};
+    }
+
+    std::any NodeCounter::visit_unary(const Unary& expr) {
+        ++m_count;
+
+        return expr.inner->accept_visitor(*this);
+    }
+
+    std::any NodeCounter::visit_binary(const Binary& expr) {
+        ++m_count;
+        expr.left->accept_visitor(*this);
+
+        return expr.right->accept_visitor(*this);
+    }
+
+    std::any NodeCounter::visit_call(const Call& expr) {
+        ++m_count;
+
+        for (const auto& arg : expr.args) {
+            arg->accept_visitor(*this);
+        }
+
+        return {};
+    }
+
+    std::any NodeCounter::visit_native_use([[maybe_unused]] const NativeUse& stmt) {
+        ++m_count;
+
+        return {};
+    }
+
+    std::any NodeCounter::visit_import([[maybe_unused]] const Import& stmt) {
+        ++m_count;
+
+        return {};
+    }
+
+    std::any NodeCounter::visit_variable_decl(const VariableDecl& stmt) {
+        ++m_count;
+
+        return stmt.init_expr->accept_visitor(*this);
+    }
+
+    std::any NodeCounter::visit_function_decl(const FunctionDecl& stmt) {
+        ++m_count;
+
+        return stmt.body->accept_visitor(*this);
+    }
+
+    std::any NodeCounter::visit_expr_stmt(const ExprStmt& stmt) {
+        ++m_count;
+
+        return stmt.inner->accept_visitor(*this);
+    }
+
+    std::any NodeCounter::visit_block(const Block& stmt) {
+        ++m_count;
+
+        for (const auto& inner_stmt : stmt.stmts) {
+            inner_stmt->accept_visitor(*this);
+        }
+
+        return {};
+    }
+
+    std::any NodeCounter::visit_return(const Return& stmt) {
+        ++m_count;
+
+        return stmt.result_expr->accept_visitor(*this);
+    }
+
+    std::any NodeCounter::visit_if(const If& stmt) {
+        ++m_count;
+        stmt.test->accept_visitor(*this);
+        stmt.truthy_body->accept_visitor(*this);
+
+        if (stmt.falsy_body) {
+            stmt.falsy_body->accept_visitor(*this);
+        }
+
+        return {};
+    }
+
+    std::any NodeCounter::visit_while(const While& stmt) {
+        ++m_count;
+        stmt.test->accept_visitor(*this);
+
+        return stmt.body->accept_visitor(*this);
+    }
+
+    std::size_t NodeCounter::operator()(const std::vector<StmtPtr>& ast) {
+        m_count = 0;
+
+        for (const auto& stmt : ast) {
+            stmt->accept_visitor(*this);
+        }
+
+        return m_count;
+    }
+}
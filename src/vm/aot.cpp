@@ -0,0 +1,400 @@
+#include <cmath>
+#include <format>
+#include <print>
+#include <string>
+#include <unordered_set>
+#include "vm/aot.hpp"
+#include "vm/decoder.hpp"
+#include "vm/lowering.hpp"
+
+namespace XLang::VM {
+    AotHost::AotHost()
+    : m_native_vm {XpliceProgram {
+        .func_chunks = FunctionStore {ProgramFunction {Chunk {
+            .constants = {},
+            .bytecode = {static_cast<RuntimeByte>(Opcode::xop_halt)},
+            .max_stack_depth = 0
+        }}},
+        .entry_func_id = 0,
+        .debug_funcs = {}
+    }}, m_native_funcs {}, m_fault_message {nullptr} {}
+
+    void AotHost::add_native_function(int native_id, const NativeFunction& func) {
+        if (native_id >= static_cast<int>(m_native_funcs.size())) {
+            m_native_funcs.resize(native_id + 1);
+        }
+
+        m_native_funcs[native_id] = func;
+    }
+
+    Errcode AotHost::call_native(int native_id, ArgView args, Value& result) noexcept {
+        if (native_id >= static_cast<int>(m_native_funcs.size()) || m_native_funcs[native_id].ptr() == nullptr) [[unlikely]] {
+            return raise_fault(Errcode::xerr_general, "Native function was never registered.");
+        }
+
+        const auto native_status = m_native_funcs[native_id].invoke(m_native_vm, args);
+
+        result = m_native_vm.peek_stack_top();
+        m_native_vm.handle_pop(Codegen::Locator {
+            .region = Codegen::Region::none,
+            .id = 1
+        });
+
+        if (native_status != Errcode::xerr_normal) [[unlikely]] {
+            return raise_fault(native_status, "Native function reported an error.");
+        }
+
+        return Errcode::xerr_normal;
+    }
+
+    Errcode AotHost::raise_fault(Errcode code, const char* message) noexcept {
+        if (m_fault_message == nullptr) {
+            m_fault_message = message;
+        }
+
+        return code;
+    }
+
+    const char* AotHost::fault_message() const noexcept {
+        return m_fault_message;
+    }
+
+    [[nodiscard]] static std::string int_literal(int value) {
+        /// NOTE: `-2147483648` would parse as a negated `long`, which no `Value` constructor takes.
+        if (value == std::numeric_limits<int>::min()) {
+            return "std::numeric_limits<int>::min()";
+        }
+
+        return std::to_string(value);
+    }
+
+    [[nodiscard]] static std::string float_literal(float value) {
+        if (std::isnan(value)) {
+            return "std::numeric_limits<float>::quiet_NaN()";
+        }
+
+        const auto sign = std::signbit(value) ? "-" : "";
+
+        if (std::isinf(value)) {
+            return std::format("{}std::numeric_limits<float>::infinity()", sign);
+        }
+
+        /// NOTE: hex floats round-trip exactly.
+        return std::format("{}0x{:a}f", sign, std::fabs(value));
+    }
+
+    [[nodiscard]] static std::string value_literal(const Value& value) {
+        switch (value.tag()) {
+        case ValueTag::primitive_bool:
+            return value.as_bool() ? "Value {true}" : "Value {false}";
+        case ValueTag::primitive_int:
+            return std::format("Value {{{}}}", int_literal(value.as_int()));
+        case ValueTag::primitive_float:
+            return std::format("Value {{{}}}", float_literal(value.as_float()));
+        case ValueTag::reference: {
+            const auto [region, id] = value.as_locator();
+            return std::format("Value {{Codegen::Locator {{.region = static_cast<Codegen::Region>({}), .id = {}}}}}", static_cast<int>(region), id);
+        }
+        default:
+            return "Value {}";
+        }
+    }
+
+    /**
+     * @brief Emits one function's register code as a C++ function body. Register R is `r[R]`, argument N is `args[N]`, and each jump target gets a `pc_N` label.
+     */
+    class CppFunctionEmitter {
+    private:
+        std::string m_body;
+        std::unordered_set<int> m_targets;
+
+        const RegisterCode& m_code;
+        const Value* m_consts;
+        int m_func_id;
+
+        template <typename... Args>
+        void line(std::format_string<Args...> fmt, Args&&... args) {
+            m_body.append("        ");
+            m_body.append(std::format(fmt, std::forward<Args>(args)...));
+            m_body.push_back('\n');
+        }
+
+        [[nodiscard]] std::string slot_expr(const Codegen::Locator& reg) const {
+            if (reg.id < 0) {
+                return std::format("args[{}]", -reg.id - 1);
+            }
+
+            return std::format("r[{}]", reg.id);
+        }
+
+        [[nodiscard]] std::string value_expr(const Codegen::Locator& arg) const {
+            switch (arg.region) {
+            case Codegen::Region::consts:
+                return value_literal(m_consts[arg.id]);
+            case Codegen::Region::temp_stack:
+                return slot_expr(arg);
+            default:
+                return value_literal(Value {arg});
+            }
+        }
+
+        /// @note Unboxed operand of a typed operation, folding constants into plain literals.
+        [[nodiscard]] std::string int_expr(const Codegen::Locator& arg) const {
+            if (arg.region == Codegen::Region::consts) {
+                return int_literal(m_consts[arg.id].as_int());
+            }
+
+            return std::format("{}.as_int()", value_expr(arg));
+        }
+
+        [[nodiscard]] std::string float_expr(const Codegen::Locator& arg) const {
+            if (arg.region == Codegen::Region::consts) {
+                return float_literal(m_consts[arg.id].as_float());
+            }
+
+            return std::format("{}.as_float()", value_expr(arg));
+        }
+
+        [[nodiscard]] std::string typed_expr(bool is_float, const Codegen::Locator& arg) const {
+            return is_float ? float_expr(arg) : int_expr(arg);
+        }
+
+        /// @note Arguments sit below the callee's frame base in reverse, so argument N is register `callee_base - 1 - N`.
+        [[nodiscard]] std::string call_args_expr(int argc, int callee_base) const {
+            std::string items;
+
+            for (auto arg_idx = 0; arg_idx < argc; ++arg_idx) {
+                if (arg_idx > 0) {
+                    items.append(", ");
+                }
+
+                items.append(slot_expr(Codegen::Locator {
+                    .region = Codegen::Region::temp_stack,
+                    .id = callee_base - 1 - arg_idx
+                }));
+            }
+
+            return items;
+        }
+
+        void emit_fault(const char* errcode_name, const char* message) {
+            line("return host.raise_fault(Errcode::{}, \"{}\");", errcode_name, message);
+        }
+
+        void emit_typed_binary(const std::array<Codegen::Locator, 3>& args, bool is_float, const char* op_text) {
+            line("{} = Value {{{} {} {}}};", slot_expr(args[0]), typed_expr(is_float, args[1]), op_text, typed_expr(is_float, args[2]));
+        }
+
+        void emit_typed_divide(const std::array<Codegen::Locator, 3>& args, bool is_float) {
+            line("if ({} == {}) {{", typed_expr(is_float, args[2]), is_float ? "0.0f" : "0");
+            line("    return host.raise_fault(Errcode::xerr_arithmetic, \"Cannot divide by zero!\");");
+            line("}}");
+            emit_typed_binary(args, is_float, "/");
+        }
+
+        void emit_typed_branch(const std::array<Codegen::Locator, 3>& args, bool is_float, const char* op_text) {
+            m_targets.insert(args[0].id);
+            line("if (!({} {} {})) {{", typed_expr(is_float, args[1]), op_text, typed_expr(is_float, args[2]));
+            line("    goto pc_{};", args[0].id);
+            line("}}");
+        }
+
+        void emit_generic(const std::array<Codegen::Locator, 3>& args, const char* method_name) {
+            line("{} = {}.{}({});", slot_expr(args[0]), value_expr(args[1]), method_name, value_expr(args[2]));
+            line("if ({}.is_null()) {{", slot_expr(args[0]));
+            line("    return host.raise_fault(Errcode::xerr_arithmetic, \"Invalid operands for a generic operation.\");");
+            line("}}");
+        }
+
+        void emit_negate(const std::array<Codegen::Locator, 3>& args) {
+            line("if (const auto operand = {}; operand.tag() == ValueTag::primitive_int) {{", value_expr(args[1]));
+            line("    {} = Value {{-operand.as_int()}};", slot_expr(args[0]));
+            line("}} else if (operand.tag() == ValueTag::primitive_float) {{");
+            line("    {} = Value {{-operand.as_float()}};", slot_expr(args[0]));
+            line("}} else {{");
+            line("    return host.raise_fault(Errcode::xerr_arithmetic, \"Invalid negation on non-numeric Value.\");");
+            line("}}");
+        }
+
+        void emit_call(int callee_id, int argc, int callee_base) {
+            line("{{");
+            line("    std::array<Value, {}> call_args {{{}}};", argc, call_args_expr(argc, callee_base));
+            line("    if (const auto status = xplice_fn_{}(host, call_args.data(), r[{}]); status != Errcode::xerr_normal) {{", callee_id, callee_base - argc);
+            line("        return status;");
+            line("    }}");
+            line("}}");
+        }
+
+        void emit_tail_call(int callee_id, int argc, int callee_base) {
+            if (callee_id != m_func_id) {
+                emit_call(callee_id, argc, callee_base);
+                line("result = r[{}];", callee_base - argc);
+                line("return Errcode::xerr_normal;");
+                return;
+            }
+
+            /// NOTE: a self tail call has this function's arity, so the new arguments overwrite the old ones in place.
+            for (auto arg_idx = 0; arg_idx < argc; ++arg_idx) {
+                line("args[{}] = r[{}];", arg_idx, callee_base - 1 - arg_idx);
+            }
+
+            m_targets.insert(0);
+            line("goto pc_0;");
+        }
+
+        void emit_native_call(int native_id, int argc, int callee_base) {
+            line("{{");
+            line("    const std::array<Value, {}> native_args {{{}}};", argc, call_args_expr(argc, callee_base));
+            line("    if (const auto status = host.call_native({}, native_args, r[{}]); status != Errcode::xerr_normal) {{", native_id, callee_base - argc);
+            line("        return status;");
+            line("    }}");
+            line("}}");
+        }
+
+        void emit_instruction(const Instruction& instr) {
+            const auto& [args, op, next] = instr;
+
+            switch (op) {
+            case Opcode::xop_replace:
+                line("{} = {};", slot_expr(args[0]), value_expr(args[1]));
+                break;
+            case Opcode::xop_push:
+                line("{} = {};", slot_expr(args[0]), value_literal(Value {args[1]}));
+                break;
+            case Opcode::xop_negate:
+                emit_negate(args);
+                break;
+            case Opcode::xop_add: emit_generic(args, "add"); break;
+            case Opcode::xop_sub: emit_generic(args, "subtract"); break;
+            case Opcode::xop_mul: emit_generic(args, "multiply"); break;
+            case Opcode::xop_div: emit_generic(args, "divide"); break;
+            case Opcode::xop_cmp_eq: emit_generic(args, "compare_eq"); break;
+            case Opcode::xop_cmp_ne: emit_generic(args, "compare_ne"); break;
+            case Opcode::xop_cmp_lt: emit_generic(args, "compare_lt"); break;
+            case Opcode::xop_cmp_gt: emit_generic(args, "compare_gt"); break;
+            case Opcode::xop_log_and: emit_generic(args, "logical_and"); break;
+            case Opcode::xop_log_or: emit_generic(args, "logical_or"); break;
+            case Opcode::xop_jump:
+                m_targets.insert(args[0].id);
+                line("goto pc_{};", args[0].id);
+                break;
+            case Opcode::xop_jump_not_if:
+                m_targets.insert(args[0].id);
+                line("if (!{}.as_bool()) {{", value_expr(args[1]));
+                line("    goto pc_{};", args[0].id);
+                line("}}");
+                break;
+            case Opcode::xop_ret:
+                line("result = {};", value_expr(args[0]));
+                line("return Errcode::xerr_normal;");
+                break;
+            case Opcode::xop_call:
+                emit_call(args[0].id, args[1].id, args[2].id);
+                break;
+            case Opcode::xop_tail_call:
+                emit_tail_call(args[0].id, args[1].id, args[2].id);
+                break;
+            case Opcode::xop_call_native:
+                emit_native_call(args[0].id, args[1].id, args[2].id);
+                break;
+            case Opcode::xop_add_i32_store: emit_typed_binary(args, false, "+"); break;
+            case Opcode::xop_sub_i32_store: emit_typed_binary(args, false, "-"); break;
+            case Opcode::xop_mul_i32_store: emit_typed_binary(args, false, "*"); break;
+            case Opcode::xop_add_f32_store: emit_typed_binary(args, true, "+"); break;
+            case Opcode::xop_sub_f32_store: emit_typed_binary(args, true, "-"); break;
+            case Opcode::xop_mul_f32_store: emit_typed_binary(args, true, "*"); break;
+            case Opcode::xop_div_i32: emit_typed_divide(args, false); break;
+            case Opcode::xop_div_f32: emit_typed_divide(args, true); break;
+            case Opcode::xop_cmp_eq_i32: emit_typed_binary(args, false, "=="); break;
+            case Opcode::xop_cmp_ne_i32: emit_typed_binary(args, false, "!="); break;
+            case Opcode::xop_cmp_lt_i32: emit_typed_binary(args, false, "<"); break;
+            case Opcode::xop_cmp_gt_i32: emit_typed_binary(args, false, ">"); break;
+            case Opcode::xop_cmp_eq_f32: emit_typed_binary(args, true, "=="); break;
+            case Opcode::xop_cmp_ne_f32: emit_typed_binary(args, true, "!="); break;
+            case Opcode::xop_cmp_lt_f32: emit_typed_binary(args, true, "<"); break;
+            case Opcode::xop_cmp_gt_f32: emit_typed_binary(args, true, ">"); break;
+            case Opcode::xop_jump_not_eq_i32: emit_typed_branch(args, false, "=="); break;
+            case Opcode::xop_jump_not_ne_i32: emit_typed_branch(args, false, "!="); break;
+            case Opcode::xop_jump_not_lt_i32: emit_typed_branch(args, false, "<"); break;
+            case Opcode::xop_jump_not_gt_i32: emit_typed_branch(args, false, ">"); break;
+            case Opcode::xop_jump_not_eq_f32: emit_typed_branch(args, true, "=="); break;
+            case Opcode::xop_jump_not_ne_f32: emit_typed_branch(args, true, "!="); break;
+            case Opcode::xop_jump_not_lt_f32: emit_typed_branch(args, true, "<"); break;
+            case Opcode::xop_jump_not_gt_f32: emit_typed_branch(args, true, ">"); break;
+            case Opcode::xop_halt:
+                emit_fault("xerr_general", "Reached premature halt!");
+                break;
+            default:
+                emit_fault("xerr_general", "Unsupported opcode.");
+                break;
+            }
+        }
+
+    public:
+        CppFunctionEmitter(const RegisterCode& code, const Value* consts, int func_id)
+        : m_body {}, m_targets {}, m_code {code}, m_consts {consts}, m_func_id {func_id} {}
+
+        void operator()(std::ostream& out) {
+            const auto code_n = static_cast<int>(m_code.code.size());
+            std::vector<std::string> instr_texts;
+
+            /// NOTE: emit every instruction first, as labels are only known once all jumps have been seen.
+            for (const auto& instr : m_code.code) {
+                m_body.clear();
+                emit_instruction(instr);
+                instr_texts.push_back(std::move(m_body));
+            }
+
+            std::print(out, "    Errcode xplice_fn_{}([[maybe_unused]] AotHost& host, [[maybe_unused]] Value* args, [[maybe_unused]] Value& result) {{\n", m_func_id);
+            std::print(out, "        [[maybe_unused]] std::array<Value, {}> r {{}};\n\n", m_code.register_count);
+
+            for (auto pc = 0; pc < code_n; ++pc) {
+                if (m_targets.contains(pc)) {
+                    std::print(out, "    pc_{}:\n", pc);
+                }
+
+                std::print(out, "{}", instr_texts[pc]);
+            }
+
+            if (m_targets.contains(code_n)) {
+                std::print(out, "    pc_{}:\n", code_n);
+            }
+
+            /// NOTE: lowered code always returns before its end, so this only keeps the compiler from warning about a missing return.
+            std::print(out, "        return host.raise_fault(Errcode::xerr_general, \"Reached the end of a function without returning.\");\n");
+            std::print(out, "    }}\n");
+        }
+    };
+
+    void emit_cpp_program(const XpliceProgram& prgm, std::ostream& out) {
+        const auto& funcs = prgm.func_chunks;
+        const auto funcs_n = static_cast<int>(funcs.size());
+
+        std::print(out, "// Generated by `xplice --emit-cpp`. Build it with a host that registers its natives on an `AotHost` and calls `run_aot_program`.\n\n");
+        std::print(out, "#include <array>\n#include \"vm/aot.hpp\"\n\n");
+        std::print(out, "namespace XLang::VM {{\n");
+        std::print(out, "    namespace {{\n");
+
+        for (auto func_id = 0; func_id < funcs_n; ++func_id) {
+            std::print(out, "    [[maybe_unused]] Errcode xplice_fn_{}(AotHost& host, Value* args, Value& result);\n", func_id);
+        }
+
+        for (auto func_id = 0; func_id < funcs_n; ++func_id) {
+            const auto func_code = lower_to_registers(decode_chunk(funcs[func_id].view_code().view()));
+            CppFunctionEmitter emitter {func_code, funcs[func_id].view_code().constants.data(), func_id};
+
+            std::print(out, "\n");
+            emitter(out);
+        }
+
+        std::print(out, "    }}\n\n");
+        std::print(out, "    Errcode run_aot_program(AotHost& host) {{\n");
+        std::print(out, "        Value result;\n\n");
+        std::print(out, "        if (const auto status = xplice_fn_{}(host, nullptr, result); status != Errcode::xerr_normal) {{\n", prgm.entry_func_id);
+        std::print(out, "            return status;\n");
+        std::print(out, "        }}\n\n");
+        std::print(out, "        return (result.as_int() == 0) ? Errcode::xerr_normal : Errcode::xerr_general;\n");
+        std::print(out, "    }}\n");
+        std::print(out, "}}\n");
+    }
+}
@@ -0,0 +1,153 @@
+#include <array>
+#include <stdexcept>
+#include <span>
+#include <unordered_map>
+#include "vm/decoder.hpp"
+
+namespace XLang::VM {
+    static constexpr auto opcode_stride = 1;
+    static constexpr auto opcode_arg_stride = 5;
+    static constexpr Codegen::Locator placeholder_arg {Codegen::Region::none, -1};
+
+    static constexpr std::array<int, static_cast<std::size_t>(Opcode::last)> opcode_arity = {
+        0,
+        0,
+        1,
+        1,
+        1,
+        1,
+        1,
+        1,
+        1,
+        2,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        1,
+        1,
+        1,
+        1,
+        2,
+        3,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        3,
+        1,
+        1,
+        1,
+        2
+    };
+
+    static auto decode_i32 = [] [[nodiscard]] (std::span<const RuntimeByte> code_buffer, int position) noexcept {
+        const auto result_0 = static_cast<unsigned int>(code_buffer[position]);
+        const auto result_1 = static_cast<unsigned int>(code_buffer[position + 1]) << 8;
+        const auto result_2 = static_cast<unsigned int>(code_buffer[position + 2]) << 16;
+        const auto result_3 = static_cast<unsigned int>(code_buffer[position + 3]) << 24;
+
+        return static_cast<int>(result_0 | result_1 | result_2 | result_3);
+    };
+
+    [[nodiscard]] static constexpr bool is_jump_opcode(Opcode op) noexcept {
+        return op == Opcode::xop_jump || op == Opcode::xop_jump_if || op == Opcode::xop_jump_not_if || (op >= Opcode::xop_jump_not_eq_i32 && op <= Opcode::xop_jump_not_gt_f32);
+    }
+
+    InstructionStore decode_chunk(ChunkView chunk) {
+        const auto bytecode = chunk.bytecode;
+        const auto code_size = static_cast<int>(bytecode.size());
+
+        InstructionStore result;
+
+        /// @note Maps each instruction's starting byte offset to its index for rewriting jump targets.
+        std::unordered_map<int, int> offset_to_index;
+
+        auto byte_pos = 0;
+
+        while (byte_pos < code_size) {
+            const auto opcode_id = static_cast<unsigned int>(bytecode[byte_pos]);
+
+            if (opcode_id >= static_cast<unsigned int>(Opcode::last)) {
+                throw std::runtime_error {"Illegal opcode read."};
+            }
+
+            const auto op_arity = opcode_arity[opcode_id];
+            const auto op_size = opcode_stride + (op_arity * opcode_arg_stride);
+
+            if (byte_pos + op_size > code_size) {
+                throw std::runtime_error {"Truncated instruction found in bytecode."};
+            }
+
+            const auto instr_index = static_cast<int>(result.size());
+
+            Instruction instr {
+                .args = {placeholder_arg, placeholder_arg, placeholder_arg},
+                .op = static_cast<Opcode>(opcode_id),
+                .next = instr_index + 1
+            };
+
+            for (auto arg_num = 0; arg_num < op_arity; ++arg_num) {
+                const auto arg_byte_pos = byte_pos + opcode_stride + (arg_num * opcode_arg_stride);
+
+                instr.args[arg_num] = Codegen::Locator {
+                    .region = static_cast<Codegen::Region>(bytecode[arg_byte_pos]),
+                    .id = decode_i32(bytecode, arg_byte_pos + 1)
+                };
+            }
+
+            offset_to_index[byte_pos] = instr_index;
+            result.push_back(instr);
+            byte_pos += op_size;
+        }
+
+        /// @note Jumps were emitted with byte offsets, so rewrite them as instruction indices.
+        for (auto& instr : result) {
+            if (!is_jump_opcode(instr.op)) {
+                continue;
+            }
+
+            auto& target = instr.args[0].id;
+
+            if (const auto target_it = offset_to_index.find(target); target_it != offset_to_index.end()) {
+                target = target_it->second;
+            } else {
+                throw std::runtime_error {"Jump target does not land on an instruction boundary."};
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,796 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include "vm/jit.hpp"
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#define XLANG_JIT_HOST 1
+#else
+#define XLANG_JIT_HOST 0
+#endif
+
+namespace XLang::VM {
+    static constexpr std::size_t jit_code_bytes = 1 << 20;
+
+    /// @note Cap on compiled frames below one interpreter call, which keeps the native stack at a few megabytes whatever the call-depth limit.
+    static constexpr std::uint64_t jit_depth_budget = 200000;
+
+    /// @note Returned in `rax:rdx` by the entry stub. A non-zero status means the compiled code bailed out.
+    struct JitReturn {
+        std::uint64_t result_bits;
+        std::uint64_t status;
+    };
+
+    using jit_entry_stub = JitReturn(Value* frame, Value* stack_limit, std::uint64_t depth_budget, const void* entry);
+
+    /**
+     * @brief Saves the registers compiled code keeps pinned, loads the stack limit into `r12` and the depth budget into `r13`, then calls the entry. Compiled code keeps the frame pointer in `rbx`.
+     */
+    static constexpr unsigned char entry_stub_bytes[] {
+        0x53,                   // push rbx
+        0x41, 0x54,             // push r12
+        0x41, 0x55,             // push r13
+        0x49, 0x89, 0xF4,       // mov r12, rsi
+        0x49, 0x89, 0xD5,       // mov r13, rdx
+        0xFF, 0xD1,             // call rcx
+        0x41, 0x5D,             // pop r13
+        0x41, 0x5C,             // pop r12
+        0x5B,                   // pop rbx
+        0xC3                    // ret
+    };
+
+    /// @note Slow path for generic and `f32` operations, which keep their interpreter semantics. Returns non-zero on a fault.
+    static std::uint64_t jit_slow_op(std::uint32_t op_code, Value* dst, const Value* lhs, const Value* rhs) noexcept {
+        Value result;
+
+        switch (static_cast<Opcode>(op_code)) {
+        case Opcode::xop_negate:
+            if (lhs->tag() == ValueTag::primitive_int) {
+                result = Value {-lhs->as_int()};
+            } else if (lhs->tag() == ValueTag::primitive_float) {
+                result = Value {-lhs->as_float()};
+            }
+            break;
+        case Opcode::xop_add: result = lhs->add(*rhs); break;
+        case Opcode::xop_sub: result = lhs->subtract(*rhs); break;
+        case Opcode::xop_mul: result = lhs->multiply(*rhs); break;
+        case Opcode::xop_div: result = lhs->divide(*rhs); break;
+        case Opcode::xop_cmp_eq: result = lhs->compare_eq(*rhs); break;
+        case Opcode::xop_cmp_ne: result = lhs->compare_ne(*rhs); break;
+        case Opcode::xop_cmp_lt: result = lhs->compare_lt(*rhs); break;
+        case Opcode::xop_cmp_gt: result = lhs->compare_gt(*rhs); break;
+        case Opcode::xop_log_and: result = lhs->logical_and(*rhs); break;
+        case Opcode::xop_log_or: result = lhs->logical_or(*rhs); break;
+        case Opcode::xop_add_f32_store: result = Value {lhs->as_float() + rhs->as_float()}; break;
+        case Opcode::xop_sub_f32_store: result = Value {lhs->as_float() - rhs->as_float()}; break;
+        case Opcode::xop_mul_f32_store: result = Value {lhs->as_float() * rhs->as_float()}; break;
+        case Opcode::xop_div_f32:
+            if (rhs->as_float() != 0.0f) {
+                result = Value {lhs->as_float() / rhs->as_float()};
+            }
+            break;
+        case Opcode::xop_cmp_eq_f32: result = Value {lhs->as_float() == rhs->as_float()}; break;
+        case Opcode::xop_cmp_ne_f32: result = Value {lhs->as_float() != rhs->as_float()}; break;
+        case Opcode::xop_cmp_lt_f32: result = Value {lhs->as_float() < rhs->as_float()}; break;
+        case Opcode::xop_cmp_gt_f32: result = Value {lhs->as_float() > rhs->as_float()}; break;
+        default: break;
+        }
+
+        *dst = result;
+
+        return result.is_null() ? 1U : 0U;
+    }
+
+    /// @note Slow path for the fused `f32` branches. Returns non-zero when the comparison holds.
+    static std::uint64_t jit_float_check(std::uint32_t op_code, const Value* lhs, const Value* rhs) noexcept {
+        const auto lhs_float = lhs->as_float();
+        const auto rhs_float = rhs->as_float();
+
+        switch (static_cast<Opcode>(op_code)) {
+        case Opcode::xop_jump_not_eq_f32: return lhs_float == rhs_float;
+        case Opcode::xop_jump_not_ne_f32: return lhs_float != rhs_float;
+        case Opcode::xop_jump_not_lt_f32: return lhs_float < rhs_float;
+        default: return lhs_float > rhs_float;
+        }
+    }
+
+    [[nodiscard]] static constexpr bool is_frame_operand(const Codegen::Locator& arg) noexcept {
+        return arg.region == Codegen::Region::consts || arg.region == Codegen::Region::temp_stack;
+    }
+
+    [[nodiscard]] static constexpr bool is_supported_instruction(const Instruction& instr) noexcept {
+        const auto& [args, op, next] = instr;
+
+        switch (op) {
+        case Opcode::xop_push:
+        case Opcode::xop_jump:
+        case Opcode::xop_call:
+        case Opcode::xop_tail_call:
+            return true;
+        case Opcode::xop_replace:
+        case Opcode::xop_negate:
+        case Opcode::xop_jump_not_if:
+            return is_frame_operand(args[1]);
+        case Opcode::xop_ret:
+            return is_frame_operand(args[0]);
+        case Opcode::xop_add:
+        case Opcode::xop_sub:
+        case Opcode::xop_mul:
+        case Opcode::xop_div:
+        case Opcode::xop_cmp_eq:
+        case Opcode::xop_cmp_ne:
+        case Opcode::xop_cmp_lt:
+        case Opcode::xop_cmp_gt:
+        case Opcode::xop_log_and:
+        case Opcode::xop_log_or:
+        case Opcode::xop_div_i32:
+        case Opcode::xop_div_f32:
+        case Opcode::xop_cmp_eq_i32:
+        case Opcode::xop_cmp_ne_i32:
+        case Opcode::xop_cmp_lt_i32:
+        case Opcode::xop_cmp_gt_i32:
+        case Opcode::xop_cmp_eq_f32:
+        case Opcode::xop_cmp_ne_f32:
+        case Opcode::xop_cmp_lt_f32:
+        case Opcode::xop_cmp_gt_f32:
+        case Opcode::xop_add_i32_store:
+        case Opcode::xop_sub_i32_store:
+        case Opcode::xop_mul_i32_store:
+        case Opcode::xop_add_f32_store:
+        case Opcode::xop_sub_f32_store:
+        case Opcode::xop_mul_f32_store:
+        case Opcode::xop_jump_not_eq_i32:
+        case Opcode::xop_jump_not_ne_i32:
+        case Opcode::xop_jump_not_lt_i32:
+        case Opcode::xop_jump_not_gt_i32:
+        case Opcode::xop_jump_not_eq_f32:
+        case Opcode::xop_jump_not_ne_f32:
+        case Opcode::xop_jump_not_lt_f32:
+        case Opcode::xop_jump_not_gt_f32:
+            return is_frame_operand(args[1]) && is_frame_operand(args[2]);
+        default:
+            return false;
+        }
+    }
+
+    enum class X64Reg : unsigned char {
+        rax = 0,
+        rcx = 1,
+        rdx = 2,
+        rsi = 6,
+        rdi = 7
+    };
+
+    /// @note Low nibble of the `jcc` / `setcc` opcodes.
+    enum class X64Cond : unsigned char {
+        equal = 0x4,
+        not_equal = 0x5,
+        less = 0xC,
+        greater_equal = 0xD,
+        less_equal = 0xE,
+        greater = 0xF
+    };
+
+    enum class X64IntOp : unsigned char {
+        add,
+        sub,
+        imul,
+        cmp
+    };
+
+    /**
+     * @brief Emits the templates of one function. Frame registers are addressed as `[rbx + disp32]`, and only `rax`, `rcx`, `rdx`, `rsi`, and `rdi` are scratch, so calls between compiled functions save nothing but `rbx`.
+     */
+    class TemplateEmitter {
+    private:
+        std::vector<unsigned char> m_bytes;
+
+        /// @note Start of each instruction's template, plus one past the end that lands on the bailout path.
+        std::vector<int> m_pc_offsets;
+        std::vector<std::pair<int, int>> m_pc_patches;
+        std::vector<int> m_bailout_patches;
+        std::vector<int> m_epilogue_patches;
+
+        const RegisterCode& m_code;
+        const Value* m_consts;
+        const void* const* m_entries;
+        int m_func_id;
+        int m_body_pos;
+
+        void emit(std::initializer_list<unsigned char> bytes) {
+            m_bytes.insert(m_bytes.end(), bytes);
+        }
+
+        void emit_imm32(std::int32_t imm) {
+            const auto bits = std::bit_cast<std::uint32_t>(imm);
+
+            for (auto shift = 0; shift < 32; shift += 8) {
+                m_bytes.push_back(static_cast<unsigned char>(bits >> shift));
+            }
+        }
+
+        void emit_imm64(std::uint64_t imm) {
+            for (auto shift = 0; shift < 64; shift += 8) {
+                m_bytes.push_back(static_cast<unsigned char>(imm >> shift));
+            }
+        }
+
+        [[nodiscard]] int position() const noexcept {
+            return static_cast<int>(m_bytes.size());
+        }
+
+        /// @note Emits a zeroed `rel32` and returns where it sits for patching.
+        [[nodiscard]] int emit_rel32_slot() {
+            const auto slot = position();
+
+            emit_imm32(0);
+
+            return slot;
+        }
+
+        void patch_rel32(int slot, int target) {
+            const auto rel = std::bit_cast<std::uint32_t>(target - (slot + 4));
+
+            for (auto byte_idx = 0; byte_idx < 4; ++byte_idx) {
+                m_bytes[slot + byte_idx] = static_cast<unsigned char>(rel >> (byte_idx * 8));
+            }
+        }
+
+        [[nodiscard]] static constexpr std::int32_t frame_disp(int reg_id) noexcept {
+            return reg_id * static_cast<std::int32_t>(sizeof(Value));
+        }
+
+        /// @note ModRM byte for `[rbx + disp32]` with `reg` in the middle field.
+        [[nodiscard]] static constexpr unsigned char frame_modrm(X64Reg reg) noexcept {
+            return static_cast<unsigned char>(0x80 | (static_cast<unsigned char>(reg) << 3) | 0x3);
+        }
+
+        [[nodiscard]] const Value& constant_at(const Codegen::Locator& arg) const noexcept {
+            return m_consts[arg.id];
+        }
+
+        /// @note `mov dst, qword operand`
+        void load_value(X64Reg dst, const Codegen::Locator& operand) {
+            if (operand.region == Codegen::Region::consts) {
+                emit({0x48, static_cast<unsigned char>(0xB8 + static_cast<unsigned char>(dst))});
+                emit_imm64(std::bit_cast<std::uint64_t>(constant_at(operand)));
+            } else {
+                emit({0x48, 0x8B, frame_modrm(dst)});
+                emit_imm32(frame_disp(operand.id));
+            }
+        }
+
+        /// @note `mov qword [rbx + reg], rax`
+        void store_rax(const Codegen::Locator& reg) {
+            emit({0x48, 0x89, frame_modrm(X64Reg::rax)});
+            emit_imm32(frame_disp(reg.id));
+        }
+
+        /// @note `mov dst32, payload`, which only reads the low half of a `Value`.
+        void load_int(X64Reg dst, const Codegen::Locator& operand) {
+            if (operand.region == Codegen::Region::consts) {
+                emit({static_cast<unsigned char>(0xB8 + static_cast<unsigned char>(dst))});
+                emit_imm32(constant_at(operand).as_int());
+            } else {
+                emit({0x8B, frame_modrm(dst)});
+                emit_imm32(frame_disp(operand.id));
+            }
+        }
+
+        /// @note `op eax, payload`
+        void int_op_eax(X64IntOp op, const Codegen::Locator& operand) {
+            if (operand.region == Codegen::Region::consts) {
+                switch (op) {
+                case X64IntOp::add: emit({0x05}); break;
+                case X64IntOp::sub: emit({0x2D}); break;
+                case X64IntOp::imul: emit({0x69, 0xC0}); break;
+                case X64IntOp::cmp: emit({0x3D}); break;
+                }
+
+                emit_imm32(constant_at(operand).as_int());
+                return;
+            }
+
+            switch (op) {
+            case X64IntOp::add: emit({0x03}); break;
+            case X64IntOp::sub: emit({0x2B}); break;
+            case X64IntOp::imul: emit({0x0F, 0xAF}); break;
+            case X64IntOp::cmp: emit({0x3B}); break;
+            }
+
+            emit({frame_modrm(X64Reg::rax)});
+            emit_imm32(frame_disp(operand.id));
+        }
+
+        /// @note Sets the tag bits over a zero-extended payload in `rax` with one `bts` per bit, matching `Value`'s packing.
+        void box_rax(ValueTag tag) {
+            const auto tag_bits = static_cast<unsigned char>(tag);
+
+            for (unsigned char bit = 0; bit < 8; ++bit) {
+                if ((tag_bits >> bit) & 1U) {
+                    emit({0x48, 0x0F, 0xBA, 0xE8, static_cast<unsigned char>(32 + bit)});
+                }
+            }
+        }
+
+        /// @note `lea dst, [rbx + reg]` or `mov dst, &constant`.
+        void address_of(X64Reg dst, const Codegen::Locator& operand) {
+            if (operand.region == Codegen::Region::consts) {
+                emit({0x48, static_cast<unsigned char>(0xB8 + static_cast<unsigned char>(dst))});
+                emit_imm64(std::bit_cast<std::uint64_t>(&constant_at(operand)));
+            } else {
+                emit({0x48, 0x8D, frame_modrm(dst)});
+                emit_imm32(frame_disp(operand.id));
+            }
+        }
+
+        /// @note `mov rax, helper; call rax`
+        template <typename Helper>
+        void call_helper(Helper* helper) {
+            emit({0x48, 0xB8});
+            emit_imm64(std::bit_cast<std::uint64_t>(helper));
+            emit({0xFF, 0xD0});
+        }
+
+        void jump_to_pc(int target_pc) {
+            emit({0xE9});
+            m_pc_patches.emplace_back(emit_rel32_slot(), target_pc);
+        }
+
+        void jcc_to_pc(X64Cond cond, int target_pc) {
+            emit({0x0F, static_cast<unsigned char>(0x80 | static_cast<unsigned char>(cond))});
+            m_pc_patches.emplace_back(emit_rel32_slot(), target_pc);
+        }
+
+        void jcc_to_bailout(X64Cond cond) {
+            emit({0x0F, static_cast<unsigned char>(0x80 | static_cast<unsigned char>(cond))});
+            m_bailout_patches.push_back(emit_rel32_slot());
+        }
+
+        void jcc_to_epilogue(X64Cond cond) {
+            emit({0x0F, static_cast<unsigned char>(0x80 | static_cast<unsigned char>(cond))});
+            m_epilogue_patches.push_back(emit_rel32_slot());
+        }
+
+        void jump_to_epilogue() {
+            emit({0xE9});
+            m_epilogue_patches.push_back(emit_rel32_slot());
+        }
+
+        void emit_prologue() {
+            emit({
+                0x53,                   // push rbx
+                0x48, 0x89, 0xFB,       // mov rbx, rdi
+                0x49, 0xFF, 0xCD        // dec r13
+            });
+            jcc_to_bailout(X64Cond::equal);
+
+            /// NOTE: the whole register window must fit below the JIT stack's end.
+            emit({0x48, 0x8D, frame_modrm(X64Reg::rax)});
+            emit_imm32(frame_disp(m_code.register_count));
+            emit({0x4C, 0x39, 0xE0});   // cmp rax, r12
+            emit({0x0F, 0x87});         // ja
+            m_bailout_patches.push_back(emit_rel32_slot());
+
+            m_body_pos = position();
+        }
+
+        void emit_int_binary(X64IntOp op, const std::array<Codegen::Locator, 3>& args) {
+            load_int(X64Reg::rax, args[1]);
+            int_op_eax(op, args[2]);
+            box_rax(ValueTag::primitive_int);
+            store_rax(args[0]);
+        }
+
+        void emit_int_compare(X64Cond cond, const std::array<Codegen::Locator, 3>& args) {
+            load_int(X64Reg::rax, args[1]);
+            int_op_eax(X64IntOp::cmp, args[2]);
+            emit({0x0F, static_cast<unsigned char>(0x90 | static_cast<unsigned char>(cond)), 0xC0});    // setcc al
+            emit({0x0F, 0xB6, 0xC0});   // movzx eax, al
+            box_rax(ValueTag::primitive_bool);
+            store_rax(args[0]);
+        }
+
+        /// @note Jumps on the inverted condition, as `jump_not_*` branches when the comparison fails.
+        void emit_int_branch(X64Cond inverse_cond, const std::array<Codegen::Locator, 3>& args) {
+            load_int(X64Reg::rax, args[1]);
+            int_op_eax(X64IntOp::cmp, args[2]);
+            jcc_to_pc(inverse_cond, args[0].id);
+        }
+
+        void emit_divide_i32(const std::array<Codegen::Locator, 3>& args) {
+            load_int(X64Reg::rax, args[1]);
+            load_int(X64Reg::rcx, args[2]);
+            emit({0x85, 0xC9});         // test ecx, ecx
+            jcc_to_bailout(X64Cond::equal);
+            emit({0x99, 0xF7, 0xF9});   // cdq; idiv ecx
+            box_rax(ValueTag::primitive_int);
+            store_rax(args[0]);
+        }
+
+        void emit_slow_op(Opcode op, const std::array<Codegen::Locator, 3>& args) {
+            /// NOTE: `negate` has no right operand, so pass the left one twice.
+            const auto& rhs = (op == Opcode::xop_negate) ? args[1] : args[2];
+
+            emit({0xBF});
+            emit_imm32(static_cast<std::int32_t>(op));
+            address_of(X64Reg::rsi, args[0]);
+            address_of(X64Reg::rdx, args[1]);
+            address_of(X64Reg::rcx, rhs);
+            call_helper(&jit_slow_op);
+            emit({0x48, 0x85, 0xC0});   // test rax, rax
+            jcc_to_bailout(X64Cond::not_equal);
+        }
+
+        void emit_float_branch(Opcode op, const std::array<Codegen::Locator, 3>& args) {
+            emit({0xBF});
+            emit_imm32(static_cast<std::int32_t>(op));
+            address_of(X64Reg::rsi, args[1]);
+            address_of(X64Reg::rdx, args[2]);
+            call_helper(&jit_float_check);
+            emit({0x48, 0x85, 0xC0});   // test rax, rax
+            jcc_to_pc(X64Cond::equal, args[0].id);
+        }
+
+        void emit_jump_not_if(const std::array<Codegen::Locator, 3>& args) {
+            if (args[1].region == Codegen::Region::consts) {
+                if (!constant_at(args[1]).as_bool()) {
+                    jump_to_pc(args[0].id);
+                }
+
+                return;
+            }
+
+            emit({0xF6, frame_modrm(X64Reg::rax)});     // test byte [rbx + disp32], 1
+            emit_imm32(frame_disp(args[1].id));
+            emit({0x01});
+            jcc_to_pc(X64Cond::equal, args[0].id);
+        }
+
+        /// @note Leaves the callee's result in `rax`, propagating a bailout straight to this function's epilogue.
+        void emit_call(int callee_id, int callee_base) {
+            emit({0x48, 0x8D, frame_modrm(X64Reg::rdi)});   // lea rdi, [rbx + callee_base]
+            emit_imm32(frame_disp(callee_base));
+            emit({0x48, 0xB8});
+            emit_imm64(std::bit_cast<std::uint64_t>(m_entries + callee_id));
+            emit({0xFF, 0x10});         // call [rax]
+            emit({0x48, 0x85, 0xD2});   // test rdx, rdx
+            jcc_to_epilogue(X64Cond::not_equal);
+        }
+
+        void emit_tail_call(const std::array<Codegen::Locator, 3>& args) {
+            const auto callee_id = args[0].id;
+            const auto argc = args[1].id;
+            const auto callee_base = args[2].id;
+
+            if (callee_id != m_func_id) {
+                /// NOTE: only self tail calls become jumps, as this frame's arity is only known for them. Others are a call and a return.
+                emit_call(callee_id, callee_base);
+                emit({0x31, 0xD2});     // xor edx, edx
+                jump_to_epilogue();
+                return;
+            }
+
+            /// NOTE: slide the new arguments over the old ones just below this frame, then restart the body.
+            for (auto arg_idx = 0; arg_idx < argc; ++arg_idx) {
+                emit({0x48, 0x8B, frame_modrm(X64Reg::rax)});
+                emit_imm32(frame_disp(callee_base - argc + arg_idx));
+                emit({0x48, 0x89, frame_modrm(X64Reg::rax)});
+                emit_imm32(frame_disp(arg_idx - argc));
+            }
+
+            emit({0xE9});
+            patch_rel32(emit_rel32_slot(), m_body_pos);
+        }
+
+        void emit_instruction(const Instruction& instr) {
+            const auto& [args, op, next] = instr;
+
+            switch (op) {
+            case Opcode::xop_replace:
+                load_value(X64Reg::rax, args[1]);
+                store_rax(args[0]);
+                break;
+            case Opcode::xop_push:
+                emit({0x48, 0xB8});
+                emit_imm64(std::bit_cast<std::uint64_t>(Value {args[1]}));
+                store_rax(args[0]);
+                break;
+            case Opcode::xop_jump:
+                jump_to_pc(args[0].id);
+                break;
+            case Opcode::xop_jump_not_if:
+                emit_jump_not_if(args);
+                break;
+            case Opcode::xop_ret:
+                load_value(X64Reg::rax, args[0]);
+                emit({0x31, 0xD2});     // xor edx, edx
+                jump_to_epilogue();
+                break;
+            case Opcode::xop_call:
+                emit_call(args[0].id, args[2].id);
+                store_rax(Codegen::Locator {
+                    .region = Codegen::Region::temp_stack,
+                    .id = args[2].id - args[1].id
+                });
+                break;
+            case Opcode::xop_tail_call:
+                emit_tail_call(args);
+                break;
+            case Opcode::xop_add_i32_store:
+                emit_int_binary(X64IntOp::add, args);
+                break;
+            case Opcode::xop_sub_i32_store:
+                emit_int_binary(X64IntOp::sub, args);
+                break;
+            case Opcode::xop_mul_i32_store:
+                emit_int_binary(X64IntOp::imul, args);
+                break;
+            case Opcode::xop_div_i32:
+                emit_divide_i32(args);
+                break;
+            case Opcode::xop_cmp_eq_i32:
+                emit_int_compare(X64Cond::equal, args);
+                break;
+            case Opcode::xop_cmp_ne_i32:
+                emit_int_compare(X64Cond::not_equal, args);
+                break;
+            case Opcode::xop_cmp_lt_i32:
+                emit_int_compare(X64Cond::less, args);
+                break;
+            case Opcode::xop_cmp_gt_i32:
+                emit_int_compare(X64Cond::greater, args);
+                break;
+            case Opcode::xop_jump_not_eq_i32:
+                emit_int_branch(X64Cond::not_equal, args);
+                break;
+            case Opcode::xop_jump_not_ne_i32:
+                emit_int_branch(X64Cond::equal, args);
+                break;
+            case Opcode::xop_jump_not_lt_i32:
+                emit_int_branch(X64Cond::greater_equal, args);
+                break;
+            case Opcode::xop_jump_not_gt_i32:
+                emit_int_branch(X64Cond::less_equal, args);
+                break;
+            case Opcode::xop_jump_not_eq_f32:
+            case Opcode::xop_jump_not_ne_f32:
+            case Opcode::xop_jump_not_lt_f32:
+            case Opcode::xop_jump_not_gt_f32:
+                emit_float_branch(op, args);
+                break;
+            default:
+                /// NOTE: generic and `f32` operations, all checked by `is_supported_instruction`.
+                emit_slow_op(op, args);
+                break;
+            }
+        }
+
+    public:
+        TemplateEmitter(const RegisterCode& code, const Value* consts, const void* const* entries, int func_id)
+        : m_bytes {}, m_pc_offsets {}, m_pc_patches {}, m_bailout_patches {}, m_epilogue_patches {}, m_code {code}, m_consts {consts}, m_entries {entries}, m_func_id {func_id}, m_body_pos {0} {}
+
+        [[nodiscard]] std::vector<unsigned char> operator()() {
+            emit_prologue();
+
+            for (const auto& instr : m_code.code) {
+                m_pc_offsets.push_back(position());
+                emit_instruction(instr);
+            }
+
+            /// NOTE: falling off the end bails out to the interpreter, like any other fault.
+            const auto bailout_pos = position();
+            m_pc_offsets.push_back(bailout_pos);
+
+            emit({0xBA});               // mov edx, 1
+            emit_imm32(1);
+
+            const auto epilogue_pos = position();
+
+            emit({
+                0x49, 0xFF, 0xC5,       // inc r13
+                0x5B,                   // pop rbx
+                0xC3                    // ret
+            });
+
+            for (const auto& [slot, target_pc] : m_pc_patches) {
+                patch_rel32(slot, m_pc_offsets[target_pc]);
+            }
+
+            for (const auto slot : m_bailout_patches) {
+                patch_rel32(slot, bailout_pos);
+            }
+
+            for (const auto slot : m_epilogue_patches) {
+                patch_rel32(slot, epilogue_pos);
+            }
+
+            return std::move(m_bytes);
+        }
+    };
+
+    TemplateJit::TemplateJit(std::span<const ChunkView> funcs, std::vector<RegisterCode> func_code, const StackConfig& stack_config)
+    : m_funcs {funcs}, m_func_code {std::move(func_code)}, m_compilable (m_func_code.size(), false), m_bailed_out (m_func_code.size(), false), m_entries (m_func_code.size(), nullptr), m_code_buffer {nullptr}, m_code_used {0}, m_jit_stack {nullptr}, m_jit_stack_values {static_cast<std::size_t>(std::max(stack_config.value_stack_limit, 1))} {
+#if XLANG_JIT_HOST
+        void* code_mem = mmap(nullptr, jit_code_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void* stack_mem = mmap(nullptr, m_jit_stack_values * sizeof(Value), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        /// NOTE: without either mapping the VM just keeps interpreting.
+        if (code_mem == MAP_FAILED || stack_mem == MAP_FAILED) {
+            if (code_mem != MAP_FAILED) {
+                munmap(code_mem, jit_code_bytes);
+            }
+
+            if (stack_mem != MAP_FAILED) {
+                munmap(stack_mem, m_jit_stack_values * sizeof(Value));
+            }
+
+            return;
+        }
+
+        m_code_buffer = static_cast<unsigned char*>(code_mem);
+        m_jit_stack = static_cast<Value*>(stack_mem);
+
+        std::memcpy(m_code_buffer, entry_stub_bytes, sizeof(entry_stub_bytes));
+        m_code_used = sizeof(entry_stub_bytes);
+        mprotect(m_code_buffer, jit_code_bytes, PROT_READ | PROT_EXEC);
+
+        mark_compilable();
+#endif
+    }
+
+    TemplateJit::~TemplateJit() {
+#if XLANG_JIT_HOST
+        if (m_code_buffer != nullptr) {
+            munmap(m_code_buffer, jit_code_bytes);
+            munmap(m_jit_stack, m_jit_stack_values * sizeof(Value));
+        }
+#endif
+    }
+
+    bool TemplateJit::is_supported_host() noexcept {
+        return XLANG_JIT_HOST != 0;
+    }
+
+    bool TemplateJit::is_compiled(int func_id) const noexcept {
+        return m_entries[func_id] != nullptr;
+    }
+
+    void TemplateJit::mark_compilable() {
+        const auto funcs_n = static_cast<int>(m_func_code.size());
+
+        for (auto func_id = 0; func_id < funcs_n; ++func_id) {
+            const auto& code = m_func_code[func_id].code;
+
+            m_compilable[func_id] = std::all_of(code.begin(), code.end(), is_supported_instruction);
+        }
+
+        /// NOTE: drop functions calling anything uncompilable until nothing changes, so compiled code never has to call back into the interpreter.
+        for (auto changed = true; changed;) {
+            changed = false;
+
+            for (auto func_id = 0; func_id < funcs_n; ++func_id) {
+                if (!m_compilable[func_id]) {
+                    continue;
+                }
+
+                for (const auto& [args, op, next] : m_func_code[func_id].code) {
+                    if (op != Opcode::xop_call && op != Opcode::xop_tail_call) {
+                        continue;
+                    }
+
+                    if (const auto callee_id = args[0].id; callee_id < 0 || callee_id >= funcs_n || !m_compilable[callee_id]) {
+                        m_compilable[func_id] = false;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    bool TemplateJit::emit_function(int func_id) {
+        TemplateEmitter emitter {m_func_code[func_id], m_funcs[func_id].constants.data(), m_entries.data(), func_id};
+        const auto machine_code = emitter();
+
+        if (m_code_used + machine_code.size() > jit_code_bytes) {
+            return false;
+        }
+
+        std::memcpy(m_code_buffer + m_code_used, machine_code.data(), machine_code.size());
+        m_entries[func_id] = m_code_buffer + m_code_used;
+        m_code_used += machine_code.size();
+
+        return true;
+    }
+
+    bool TemplateJit::compile(int func_id) {
+        if (m_code_buffer == nullptr || !m_compilable[func_id]) {
+            return false;
+        }
+
+        if (is_compiled(func_id)) {
+            return true;
+        }
+
+#if XLANG_JIT_HOST
+        /// NOTE: gather every callee not compiled yet, as compiled calls jump through `m_entries` without checking it.
+        std::vector<int> pending {func_id};
+        std::vector<bool> queued (m_func_code.size(), false);
+        queued[func_id] = true;
+
+        for (std::size_t pending_idx = 0; pending_idx < pending.size(); ++pending_idx) {
+            for (const auto& [args, op, next] : m_func_code[pending[pending_idx]].code) {
+                if (op != Opcode::xop_call && op != Opcode::xop_tail_call) {
+                    continue;
+                }
+
+                if (const auto callee_id = args[0].id; !queued[callee_id] && !is_compiled(callee_id)) {
+                    queued[callee_id] = true;
+                    pending.push_back(callee_id);
+                }
+            }
+        }
+
+        const auto old_code_used = m_code_used;
+        auto all_emitted = true;
+
+        mprotect(m_code_buffer, jit_code_bytes, PROT_READ | PROT_WRITE);
+
+        for (const auto pending_id : pending) {
+            if (!emit_function(pending_id)) {
+                all_emitted = false;
+                break;
+            }
+        }
+
+        mprotect(m_code_buffer, jit_code_bytes, PROT_READ | PROT_EXEC);
+
+        if (!all_emitted) {
+            /// NOTE: out of code space, so unpublish this batch and stop retrying the function.
+            for (const auto pending_id : pending) {
+                m_entries[pending_id] = nullptr;
+            }
+
+            m_code_used = old_code_used;
+            m_compilable[func_id] = false;
+            return false;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::optional<Value> TemplateJit::invoke(int func_id, std::span<const Value> frame_args, int frames_left, int values_left) noexcept {
+        if (m_bailed_out[func_id]) {
+            return {};
+        }
+
+        /// NOTE: the interpreter reports the overflow itself, so this is not latched as a bailout.
+        if (frames_left <= 0 || values_left <= static_cast<int>(frame_args.size())) {
+            return {};
+        }
+
+        std::copy(frame_args.begin(), frame_args.end(), m_jit_stack);
+
+        auto entry_stub = std::bit_cast<jit_entry_stub*>(m_code_buffer);
+        /// NOTE: each prologue decrements the budget and bails out when it reaches zero, so one extra unit lets exactly `frames_left` frames in.
+        const auto depth_budget = std::min(static_cast<std::uint64_t>(frames_left), jit_depth_budget) + 1;
+        const auto stack_room = std::min(static_cast<std::size_t>(values_left), m_jit_stack_values);
+
+        const auto [result_bits, status] = entry_stub(m_jit_stack + frame_args.size(), m_jit_stack + stack_room, depth_budget, m_entries[func_id]);
+
+        if (status != 0) {
+            m_bailed_out[func_id] = true;
+            return {};
+        }
+
+        return std::bit_cast<Value>(result_bits);
+    }
+}
@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "vm/lowering.hpp"
+
+namespace XLang::VM {
+    static constexpr Codegen::Locator placeholder_arg {Codegen::Region::none, -1};
+
+    [[nodiscard]] static constexpr Codegen::Locator make_register(int id) noexcept {
+        return {
+            .region = Codegen::Region::temp_stack,
+            .id = id
+        };
+    }
+
+    [[nodiscard]] static constexpr bool same_locator(const Codegen::Locator& lhs, const Codegen::Locator& rhs) noexcept {
+        return lhs.region == rhs.region && lhs.id == rhs.id;
+    }
+
+    [[nodiscard]] static constexpr bool is_jump_opcode(Opcode op) noexcept {
+        return op == Opcode::xop_jump || op == Opcode::xop_jump_not_if || (op >= Opcode::xop_jump_not_eq_i32 && op <= Opcode::xop_jump_not_gt_f32);
+    }
+
+    [[nodiscard]] static constexpr bool is_binary_opcode(Opcode op) noexcept {
+        return (op >= Opcode::xop_add && op <= Opcode::xop_log_or) || (op >= Opcode::xop_add_i32 && op <= Opcode::xop_cmp_gt_f32);
+    }
+
+    /// @note Typed arithmetic already has a three-address form in the fused `*_store` opcodes.
+    [[nodiscard]] static constexpr Opcode three_address_opcode(Opcode op) noexcept {
+        switch (op) {
+        case Opcode::xop_add_i32: return Opcode::xop_add_i32_store;
+        case Opcode::xop_sub_i32: return Opcode::xop_sub_i32_store;
+        case Opcode::xop_mul_i32: return Opcode::xop_mul_i32_store;
+        case Opcode::xop_add_f32: return Opcode::xop_add_f32_store;
+        case Opcode::xop_sub_f32: return Opcode::xop_sub_f32_store;
+        case Opcode::xop_mul_f32: return Opcode::xop_mul_f32_store;
+        default: return op;
+        }
+    }
+
+    [[nodiscard]] static constexpr Opcode branch_opcode(Opcode op) noexcept {
+        switch (op) {
+        case Opcode::xop_cmp_eq_i32: return Opcode::xop_jump_not_eq_i32;
+        case Opcode::xop_cmp_ne_i32: return Opcode::xop_jump_not_ne_i32;
+        case Opcode::xop_cmp_lt_i32: return Opcode::xop_jump_not_lt_i32;
+        case Opcode::xop_cmp_gt_i32: return Opcode::xop_jump_not_gt_i32;
+        case Opcode::xop_cmp_eq_f32: return Opcode::xop_jump_not_eq_f32;
+        case Opcode::xop_cmp_ne_f32: return Opcode::xop_jump_not_ne_f32;
+        case Opcode::xop_cmp_lt_f32: return Opcode::xop_jump_not_lt_f32;
+        case Opcode::xop_cmp_gt_f32: return Opcode::xop_jump_not_gt_f32;
+        default: return Opcode::xop_noop;
+        }
+    }
+
+    /**
+     * @brief Simulates the value stack of one function symbolically. Each slot holds either a ready operand or a pending instruction still missing its destination, so a value is only written to a register once something forces it there.
+     */
+    class RegisterLowering {
+    private:
+        /// @note A symbolic value-stack slot. `operand` is only meaningful when `is_pending` is false.
+        struct Slot {
+            Instruction pending;
+            Codegen::Locator operand;
+            bool is_pending;
+        };
+
+        std::vector<Slot> m_slots;
+        InstructionStore m_result;
+
+        /// @note Emitted jumps still holding stack-code targets.
+        std::vector<int> m_jump_sites;
+
+        /// @note Stack depth reaching each forward jump target, as code after a `ret` may leave the simulated depth stale.
+        std::unordered_map<int, int> m_target_depths;
+
+        int m_max_register;
+
+        /// @note Slot `k` lives in register `k + 1`, since register 0 holds the callee reference just like the stack engine's frame base.
+        [[nodiscard]] static constexpr int slot_register(int slot_idx) noexcept {
+            return slot_idx + 1;
+        }
+
+        [[nodiscard]] int depth() const noexcept {
+            return static_cast<int>(m_slots.size());
+        }
+
+        void note_register(const Codegen::Locator& arg) noexcept {
+            if (arg.region == Codegen::Region::temp_stack) {
+                m_max_register = std::max(m_max_register, arg.id);
+            }
+        }
+
+        void emit(Opcode op, const Codegen::Locator& arg_0, const Codegen::Locator& arg_1 = placeholder_arg, const Codegen::Locator& arg_2 = placeholder_arg) {
+            const auto instr_index = static_cast<int>(m_result.size());
+
+            if (is_jump_opcode(op)) {
+                m_jump_sites.push_back(instr_index);
+            }
+
+            note_register(arg_0);
+            note_register(arg_1);
+            note_register(arg_2);
+
+            m_result.push_back(Instruction {
+                .args = {arg_0, arg_1, arg_2},
+                .op = op,
+                .next = instr_index + 1
+            });
+        }
+
+        [[nodiscard]] static bool slot_reads(const Slot& slot, const Codegen::Locator& reg) noexcept {
+            if (slot.is_pending) {
+                return same_locator(slot.pending.args[1], reg) || same_locator(slot.pending.args[2], reg);
+            }
+
+            return same_locator(slot.operand, reg);
+        }
+
+        /// @note Snapshots every other slot still reading `reg` before that register gets overwritten.
+        void prepare_write(const Codegen::Locator& reg) {
+            const auto slots_n = depth();
+
+            for (auto slot_idx = 0; slot_idx < slots_n; ++slot_idx) {
+                if (slot_register(slot_idx) != reg.id && slot_reads(m_slots[slot_idx], reg)) {
+                    materialize(slot_idx);
+                }
+            }
+        }
+
+        void materialize(int slot_idx) {
+            const auto dst = make_register(slot_register(slot_idx));
+            auto slot = m_slots[slot_idx];
+
+            if (!slot.is_pending && same_locator(slot.operand, dst)) {
+                return;
+            }
+
+            m_slots[slot_idx] = Slot {
+                .pending = {},
+                .operand = dst,
+                .is_pending = false
+            };
+
+            prepare_write(dst);
+
+            if (slot.is_pending) {
+                emit(slot.pending.op, dst, slot.pending.args[1], slot.pending.args[2]);
+            } else {
+                emit(Opcode::xop_replace, dst, slot.operand);
+            }
+        }
+
+        /// @note Called at every basic block edge, where all slots must sit in their own registers.
+        void flush() {
+            const auto slots_n = depth();
+
+            for (auto slot_idx = 0; slot_idx < slots_n; ++slot_idx) {
+                materialize(slot_idx);
+            }
+        }
+
+        void push_operand(const Codegen::Locator& operand) {
+            m_slots.push_back(Slot {
+                .pending = {},
+                .operand = operand,
+                .is_pending = false
+            });
+        }
+
+        void push_pending(Opcode op, const Codegen::Locator& lhs, const Codegen::Locator& rhs) {
+            m_slots.push_back(Slot {
+                .pending = Instruction {
+                    .args = {placeholder_arg, lhs, rhs},
+                    .op = op,
+                    .next = 0
+                },
+                .operand = placeholder_arg,
+                .is_pending = true
+            });
+        }
+
+        [[nodiscard]] Codegen::Locator pop_operand() {
+            if (m_slots.back().is_pending) {
+                materialize(depth() - 1);
+            }
+
+            const auto operand = m_slots.back().operand;
+            m_slots.pop_back();
+
+            return operand;
+        }
+
+        /// @note Reads local N, forwarding whatever operand it currently aliases.
+        [[nodiscard]] Codegen::Locator read_local(int local_id) {
+            const auto slot_idx = local_id - 1;
+
+            if (slot_idx < 0 || slot_idx >= depth()) {
+                return make_register(local_id);
+            }
+
+            if (m_slots[slot_idx].is_pending) {
+                materialize(slot_idx);
+            }
+
+            return m_slots[slot_idx].operand;
+        }
+
+        [[nodiscard]] Codegen::Locator lower_operand(const Codegen::Locator& arg) {
+            switch (arg.region) {
+            case Codegen::Region::temp_stack:
+                return read_local(arg.id);
+            case Codegen::Region::frame_slot:
+                return make_register(-arg.id - 1);
+            default:
+                return arg;
+            }
+        }
+
+        /// @note Writes local N, snapshotting its old value for any slot still reading it.
+        void write_local(const Codegen::Locator& dst, Opcode op, const Codegen::Locator& lhs, const Codegen::Locator& rhs) {
+            const auto slot_idx = dst.id - 1;
+
+            prepare_write(dst);
+
+            if (op != Opcode::xop_replace || !same_locator(lhs, dst)) {
+                emit(op, dst, lhs, rhs);
+            }
+
+            if (slot_idx >= 0 && slot_idx < depth()) {
+                m_slots[slot_idx] = Slot {
+                    .pending = {},
+                    .operand = dst,
+                    .is_pending = false
+                };
+            }
+        }
+
+        void lower_replace(const Codegen::Locator& dst) {
+            const auto top = m_slots.back();
+            m_slots.pop_back();
+
+            if (top.is_pending) {
+                write_local(dst, top.pending.op, top.pending.args[1], top.pending.args[2]);
+            } else {
+                write_local(dst, Opcode::xop_replace, top.operand, placeholder_arg);
+            }
+        }
+
+        void lower_jump_not_if(const Codegen::Locator& target) {
+            const auto& top = m_slots.back();
+
+            if (const auto fused_op = top.is_pending ? branch_opcode(top.pending.op) : Opcode::xop_noop; fused_op != Opcode::xop_noop) {
+                const auto lhs = top.pending.args[1];
+                const auto rhs = top.pending.args[2];
+
+                m_slots.pop_back();
+                flush();
+                record_target_depth(target);
+                emit(fused_op, target, lhs, rhs);
+                return;
+            }
+
+            const auto check = pop_operand();
+
+            flush();
+            record_target_depth(target);
+            emit(Opcode::xop_jump_not_if, target, check);
+        }
+
+        void lower_call(Opcode op, const Codegen::Locator& callee, int argc) {
+            flush();
+
+            const auto callee_base = make_register(slot_register(depth()));
+
+            emit(op, callee, Codegen::Locator {Codegen::Region::none, argc}, callee_base);
+
+            m_slots.resize(depth() - argc);
+            push_operand(make_register(slot_register(depth())));
+        }
+
+        void record_target_depth(const Codegen::Locator& target) {
+            m_target_depths.try_emplace(target.id, depth());
+        }
+
+        /// @note Jumps only land on block starts, so settle every slot and adopt the depth the incoming jumps agreed on.
+        void enter_block(int stack_index) {
+            flush();
+
+            if (const auto depth_it = m_target_depths.find(stack_index); depth_it != m_target_depths.end()) {
+                const auto target_depth = depth_it->second;
+
+                while (depth() > target_depth) {
+                    m_slots.pop_back();
+                }
+
+                while (depth() < target_depth) {
+                    push_operand(make_register(slot_register(depth())));
+                }
+            }
+        }
+
+        void lower_instruction(const Instruction& instr) {
+            const auto& [args, op, next] = instr;
+
+            switch (op) {
+            case Opcode::xop_noop:
+                break;
+            case Opcode::xop_replace:
+                lower_replace(args[0]);
+                break;
+            case Opcode::xop_push:
+            case Opcode::xop_peek:
+            case Opcode::xop_load_const:
+            case Opcode::xop_push_local:
+            case Opcode::xop_push_arg:
+            case Opcode::xop_push_func:
+                if (args[0].region == Codegen::Region::routines) {
+                    push_pending(Opcode::xop_push, args[0], placeholder_arg);
+                } else {
+                    push_operand(lower_operand(args[0]));
+                }
+                break;
+            case Opcode::xop_pop:
+                m_slots.resize(std::max(0, depth() - args[0].id));
+                break;
+            case Opcode::xop_negate:
+                push_pending(op, pop_operand(), placeholder_arg);
+                break;
+            case Opcode::xop_jump:
+                flush();
+                record_target_depth(args[0]);
+                emit(op, args[0]);
+                break;
+            case Opcode::xop_jump_not_if:
+                lower_jump_not_if(args[0]);
+                break;
+            case Opcode::xop_ret:
+                emit(op, (args[0].region == Codegen::Region::none) ? pop_operand() : lower_operand(args[0]));
+                break;
+            case Opcode::xop_call:
+            case Opcode::xop_tail_call:
+                lower_call(op, args[0], args[1].id);
+                break;
+            case Opcode::xop_call_native:
+                lower_call(op, args[1], args[2].id);
+                break;
+            case Opcode::xop_add_i32_store:
+            case Opcode::xop_sub_i32_store:
+            case Opcode::xop_mul_i32_store:
+            case Opcode::xop_add_f32_store:
+            case Opcode::xop_sub_f32_store:
+            case Opcode::xop_mul_f32_store: {
+                const auto lhs = lower_operand(args[1]);
+                const auto rhs = lower_operand(args[2]);
+                write_local(args[0], op, lhs, rhs);
+                break;
+            }
+            case Opcode::xop_jump_not_eq_i32:
+            case Opcode::xop_jump_not_ne_i32:
+            case Opcode::xop_jump_not_lt_i32:
+            case Opcode::xop_jump_not_gt_i32:
+            case Opcode::xop_jump_not_eq_f32:
+            case Opcode::xop_jump_not_ne_f32:
+            case Opcode::xop_jump_not_lt_f32:
+            case Opcode::xop_jump_not_gt_f32: {
+                const auto lhs = lower_operand(args[1]);
+                const auto rhs = lower_operand(args[2]);
+                flush();
+                record_target_depth(args[0]);
+                emit(op, args[0], lhs, rhs);
+                break;
+            }
+            default:
+                if (is_binary_opcode(op)) {
+                    const auto lhs = pop_operand();
+                    const auto rhs = pop_operand();
+                    push_pending(three_address_opcode(op), lhs, rhs);
+                } else {
+                    /// NOTE: `halt` and the unimplemented object opcodes pass through unchanged, so the register engine reports them when reached.
+                    flush();
+                    emit(op, args[0], args[1], args[2]);
+                }
+                break;
+            }
+        }
+
+    public:
+        RegisterLowering() noexcept
+        : m_slots {}, m_result {}, m_jump_sites {}, m_target_depths {}, m_max_register {0} {}
+
+        [[nodiscard]] RegisterCode operator()(const InstructionStore& stack_code) {
+            const auto stack_code_n = static_cast<int>(stack_code.size());
+
+            std::unordered_set<int> block_starts;
+            std::vector<int> index_map (stack_code_n, 0);
+            std::vector<int> stack_pcs;
+
+            for (const auto& instr : stack_code) {
+                if (is_jump_opcode(instr.op)) {
+                    block_starts.insert(instr.args[0].id);
+                }
+            }
+
+            for (auto stack_index = 0; stack_index < stack_code_n; ++stack_index) {
+                if (block_starts.contains(stack_index)) {
+                    enter_block(stack_index);
+                }
+
+                index_map[stack_index] = static_cast<int>(m_result.size());
+                lower_instruction(stack_code[stack_index]);
+                stack_pcs.resize(m_result.size(), stack_index);
+            }
+
+            /// @note Retarget jumps from stack-code indices to their lowered block starts.
+            for (const auto jump_site : m_jump_sites) {
+                auto& target = m_result[jump_site].args[0].id;
+                target = index_map[target];
+            }
+
+            return {
+                .code = std::move(m_result),
+                .stack_pcs = std::move(stack_pcs),
+                .register_count = m_max_register + 1
+            };
+        }
+    };
+
+    RegisterCode lower_to_registers(const InstructionStore& stack_code) {
+        RegisterLowering lowering;
+
+        return lowering(stack_code);
+    }
+}
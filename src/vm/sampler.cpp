@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include "vm/sampler.hpp"
+#include "vm/vm.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/time.h>
+#define XLANG_SAMPLER_ITIMER 1
+#else
+#define XLANG_SAMPLER_ITIMER 0
+#endif
+
+namespace XLang::VM {
+    namespace {
+        std::atomic<StackSampler*> g_active_sampler {nullptr};
+
+#if XLANG_SAMPLER_ITIMER
+        struct sigaction g_previous_action {};
+#endif
+
+        [[nodiscard]] std::string frame_label(std::span<const FunctionDebugInfo> debug_funcs, const VM& vm, const SampledFrame& frame) {
+            if (frame.func_id < 0 || static_cast<std::size_t>(frame.func_id) >= debug_funcs.size()) {
+                return std::format("fn#{}", frame.func_id);
+            }
+
+            const auto& [func_name, func_lines] = debug_funcs[frame.func_id];
+            const auto stack_pc = vm.stack_pc(frame.func_id, frame.pc);
+
+            /// NOTE: the line of a pc is the one starting the last run at or before it.
+            const auto line_it = std::ranges::upper_bound(func_lines, stack_pc, {}, &LineEntry::pc);
+
+            if (line_it == func_lines.begin()) {
+                return func_name;
+            }
+
+            return std::format("{}:{}", func_name, std::prev(line_it)->line);
+        }
+    }
+
+    bool StackSampler::is_supported_host() noexcept {
+        return XLANG_SAMPLER_ITIMER != 0;
+    }
+
+    StackSampler::StackSampler(const VM& vm, int interval_us, std::size_t max_frames)
+    : m_vm {&vm}, m_frames (max_frames, SampledFrame {-1, 0}), m_frames_used {0}, m_samples_n {0}, m_dropped_n {0}, m_interval_us {std::max(interval_us, 1)}, m_running {false} {}
+
+    StackSampler::~StackSampler() {
+        stop();
+    }
+
+#if XLANG_SAMPLER_ITIMER
+    void StackSampler::start() {
+        if (m_running) {
+            return;
+        }
+
+        if (StackSampler* no_sampler = nullptr; !g_active_sampler.compare_exchange_strong(no_sampler, this)) {
+            throw std::runtime_error {"Another stack sampler is already running."};
+        }
+
+        struct sigaction tick_action {};
+        tick_action.sa_handler = handle_tick;
+        tick_action.sa_flags = SA_RESTART;
+        sigemptyset(&tick_action.sa_mask);
+
+        sigaction(SIGPROF, &tick_action, &g_previous_action);
+
+        const itimerval tick_timer {
+            .it_interval = {.tv_sec = m_interval_us / 1000000, .tv_usec = m_interval_us % 1000000},
+            .it_value = {.tv_sec = m_interval_us / 1000000, .tv_usec = m_interval_us % 1000000}
+        };
+
+        setitimer(ITIMER_PROF, &tick_timer, nullptr);
+        m_running = true;
+    }
+
+    void StackSampler::stop() noexcept {
+        if (!m_running) {
+            return;
+        }
+
+        /// NOTE: disarm the timer before dropping the handler, so a late tick never hits the default action and kills the process.
+        const itimerval no_timer {};
+        setitimer(ITIMER_PROF, &no_timer, nullptr);
+        sigaction(SIGPROF, &g_previous_action, nullptr);
+
+        g_active_sampler.store(nullptr);
+        m_running = false;
+    }
+#else
+    void StackSampler::start() {}
+
+    void StackSampler::stop() noexcept {}
+#endif
+
+    std::size_t StackSampler::sample_count() const noexcept {
+        return m_samples_n;
+    }
+
+    std::size_t StackSampler::dropped_count() const noexcept {
+        return m_dropped_n;
+    }
+
+    CollapsedStacks StackSampler::collapse(std::span<const FunctionDebugInfo> debug_funcs) const {
+        CollapsedStacks stacks;
+        std::size_t frame_idx = 0;
+
+        while (frame_idx < m_frames_used) {
+            const auto depth = static_cast<std::size_t>(m_frames[frame_idx].pc);
+            std::string stack_text;
+
+            for (std::size_t depth_idx = 1; depth_idx <= depth; ++depth_idx) {
+                if (depth_idx > 1) {
+                    stack_text += ';';
+                }
+
+                stack_text += frame_label(debug_funcs, *m_vm, m_frames[frame_idx + depth_idx]);
+            }
+
+            ++stacks[stack_text];
+            frame_idx += 1 + depth;
+        }
+
+        return stacks;
+    }
+
+    void StackSampler::handle_tick([[maybe_unused]] int signal_id) noexcept {
+        if (auto* sampler = g_active_sampler.load(std::memory_order_relaxed); sampler != nullptr) {
+            sampler->take_sample();
+        }
+    }
+
+    void StackSampler::take_sample() noexcept {
+        const auto frames_left = m_frames.size() - m_frames_used;
+
+        if (frames_left < 1 + static_cast<std::size_t>(cm_max_depth)) {
+            ++m_dropped_n;
+            return;
+        }
+
+        const std::span<SampledFrame> sample_frames {m_frames.data() + m_frames_used + 1, cm_max_depth};
+
+        if (const auto depth = m_vm->snapshot_call_stack(sample_frames); depth > 0) {
+            m_frames[m_frames_used] = {-1, static_cast<int>(depth)};
+            m_frames_used += 1 + depth;
+            ++m_samples_n;
+        }
+    }
+}
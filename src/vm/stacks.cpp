@@ -0,0 +1,151 @@
+#include <csetjmp>
+#include <csignal>
+#include <mutex>
+#include "vm/stacks.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define XLANG_GUARD_PAGES 1
+#else
+#define XLANG_GUARD_PAGES 0
+#endif
+
+namespace XLang::VM {
+    bool GuardedRegion::is_supported_host() noexcept {
+        return XLANG_GUARD_PAGES != 0;
+    }
+
+#if XLANG_GUARD_PAGES
+    [[nodiscard]] static std::size_t host_page_size() noexcept {
+        static const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+        return page_size;
+    }
+
+    GuardedRegion::GuardedRegion(std::size_t count, std::size_t elem_size)
+    : m_base {nullptr}, m_usable_bytes {0}, m_guard_bytes {host_page_size()} {
+        const auto page_size = m_guard_bytes;
+
+        m_usable_bytes = ((count * elem_size + page_size - 1) / page_size) * page_size;
+
+        void* region_mem = mmap(nullptr, m_usable_bytes + m_guard_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if (region_mem == MAP_FAILED) {
+            throw std::bad_alloc {};
+        }
+
+        m_base = static_cast<unsigned char*>(region_mem);
+
+        /// NOTE: stacks grow upward, so the guard page sits right past the usable end.
+        if (mprotect(m_base + m_usable_bytes, m_guard_bytes, PROT_NONE) != 0) {
+            munmap(m_base, m_usable_bytes + m_guard_bytes);
+            throw std::bad_alloc {};
+        }
+    }
+
+    GuardedRegion::~GuardedRegion() {
+        munmap(m_base, m_usable_bytes + m_guard_bytes);
+    }
+#else
+    GuardedRegion::GuardedRegion([[maybe_unused]] std::size_t count, [[maybe_unused]] std::size_t elem_size)
+    : m_base {nullptr}, m_usable_bytes {0}, m_guard_bytes {0} {
+        throw std::bad_alloc {};
+    }
+
+    GuardedRegion::~GuardedRegion() = default;
+#endif
+
+    void* GuardedRegion::base() const noexcept {
+        return m_base;
+    }
+
+    std::size_t GuardedRegion::mapped_bytes() const noexcept {
+        return m_usable_bytes + m_guard_bytes;
+    }
+
+    bool GuardedRegion::guard_contains(const void* addr) const noexcept {
+        const auto* byte_addr = static_cast<const unsigned char*>(addr);
+
+        return byte_addr >= m_base + m_usable_bytes && byte_addr < m_base + m_usable_bytes + m_guard_bytes;
+    }
+
+#if XLANG_GUARD_PAGES
+    namespace {
+        /// @brief Guards of the run active on one thread, plus where to jump back to.
+        struct GuardedRun {
+            const GuardedRegion* values;
+            const GuardedRegion* frames;
+            sigjmp_buf resume_env;
+        };
+
+        thread_local GuardedRun* t_active_run = nullptr;
+        struct sigaction g_previous_action {};
+        std::once_flag g_handler_once;
+
+        void on_guard_fault(int signal_id, siginfo_t* info, void* ucontext) {
+            if (auto* run = t_active_run; run != nullptr) {
+                if (run->values->guard_contains(info->si_addr)) {
+                    siglongjmp(run->resume_env, static_cast<int>(GuardHit::value_stack));
+                }
+
+                if (run->frames->guard_contains(info->si_addr)) {
+                    siglongjmp(run->resume_env, static_cast<int>(GuardHit::call_stack));
+                }
+            }
+
+            /// NOTE: not ours, so chain to whatever handled SIGSEGV before, or restore it and let the store fault again.
+            if ((g_previous_action.sa_flags & SA_SIGINFO) != 0 && g_previous_action.sa_sigaction != nullptr) {
+                g_previous_action.sa_sigaction(signal_id, info, ucontext);
+            } else {
+                sigaction(SIGSEGV, &g_previous_action, nullptr);
+            }
+        }
+
+        void install_guard_handler() {
+            struct sigaction guard_action {};
+            guard_action.sa_sigaction = on_guard_fault;
+            guard_action.sa_flags = SA_SIGINFO | SA_NODEFER;
+            sigemptyset(&guard_action.sa_mask);
+
+            sigaction(SIGSEGV, &guard_action, &g_previous_action);
+        }
+
+        [[nodiscard]] GuardHit enter_guarded_run(GuardedRun& run, void (*body)(void*), void* context) {
+            /// NOTE: nothing here is modified between `sigsetjmp` and a jump back, so no local needs to be volatile.
+            if (const auto hit = sigsetjmp(run.resume_env, 1); hit != 0) {
+                return static_cast<GuardHit>(hit);
+            }
+
+            body(context);
+
+            return GuardHit::none;
+        }
+    }
+
+    GuardHit run_with_stack_guards(const GuardedRegion& values, const GuardedRegion& frames, void (*body)(void*), void* context) {
+        std::call_once(g_handler_once, install_guard_handler);
+
+        GuardedRun run {
+            .values = &values,
+            .frames = &frames,
+            .resume_env = {}
+        };
+
+        auto* outer_run = t_active_run;
+        t_active_run = &run;
+
+        const auto hit = enter_guarded_run(run, body, context);
+
+        t_active_run = outer_run;
+
+        return hit;
+    }
+#else
+    GuardHit run_with_stack_guards([[maybe_unused]] const GuardedRegion& values, [[maybe_unused]] const GuardedRegion& frames, void (*body)(void*), void* context) {
+        body(context);
+
+        return GuardHit::none;
+    }
+#endif
+}
@@ -0,0 +1,315 @@
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "vm/verifier.hpp"
+
+namespace XLang::VM {
+    static constexpr auto unknown_height = -1;
+    static constexpr auto unknown_arity = -1;
+
+    [[noreturn]] static void fail_verify(int func_id, int pc, const char* reason) {
+        throw std::runtime_error {std::format("Bytecode verification failed at function {}, instruction {}: {}", func_id, pc, reason)};
+    }
+
+    [[nodiscard]] static constexpr bool is_binary_opcode(Opcode op) noexcept {
+        return (op >= Opcode::xop_add && op <= Opcode::xop_log_or) || (op >= Opcode::xop_add_i32 && op <= Opcode::xop_cmp_gt_f32);
+    }
+
+    /// @brief Walks one function's reachable instructions, tracking lower and upper bounds on the stack height from the frame base (the callee reference counts as 1).
+    class ChunkVerifier {
+    public:
+        ChunkVerifier(const InstructionStore& code, int consts_n, int natives_n, std::span<const int> arities, int func_id, int height_limit)
+        : m_code {code}, m_arities {arities}, m_heights (code.size(), unknown_height), m_peak_heights (code.size(), unknown_height), m_worklist {}, m_consts_n {consts_n}, m_natives_n {natives_n}, m_func_id {func_id}, m_height_limit {height_limit} {}
+
+        void operator()() {
+            if (m_code.empty()) {
+                fail_verify(m_func_id, 0, "function has no instructions.");
+            }
+
+            flow_to(0, 0, 1, 1);
+
+            while (!m_worklist.empty()) {
+                const auto pc = m_worklist.back();
+                m_worklist.pop_back();
+
+                check_instruction(pc, m_heights[pc], m_peak_heights[pc]);
+            }
+        }
+
+    private:
+        void flow_to(int pc, int target, int height, int peak_height) {
+            if (target < 0 || target >= static_cast<int>(m_code.size())) {
+                fail_verify(m_func_id, pc, "control runs off the end of the function.");
+            }
+
+            /// NOTE: the VM sizes each frame by the recorded max depth once, so every path must stay within it, and a loop must not grow the stack per iteration.
+            if (peak_height > m_height_limit) {
+                fail_verify(m_func_id, pc, "stack grows past the function's max stack depth.");
+            }
+
+            const auto known_peak = m_peak_heights[target];
+
+            if (target <= pc && known_peak != unknown_height && peak_height > known_peak) {
+                fail_verify(m_func_id, pc, "stack grows on every iteration of a loop.");
+            }
+
+            /// NOTE: `EmitCodePass` can leave stray temporaries on one branch, so a merge point keeps the lowest incoming height and gets rechecked when it drops. Heights are then lower bounds on every path, which is all the checks need since temporaries are addressed from the frame base. Peak heights are the matching upper bounds.
+            const auto known_height = m_heights[target];
+            const auto lowers_height = known_height == unknown_height || height < known_height;
+            const auto raises_peak = known_peak == unknown_height || peak_height > known_peak;
+
+            if (lowers_height) {
+                m_heights[target] = height;
+            }
+
+            if (raises_peak) {
+                m_peak_heights[target] = peak_height;
+            }
+
+            if (lowers_height || raises_peak) {
+                m_worklist.push_back(target);
+            }
+        }
+
+        void expect_temps(int pc, int height, int needed) const {
+            if (needed < 0 || height - 1 < needed) {
+                fail_verify(m_func_id, pc, "stack underflow.");
+            }
+        }
+
+        void expect_const(int pc, const Codegen::Locator& arg) const {
+            if (arg.id < 0 || arg.id >= m_consts_n) {
+                fail_verify(m_func_id, pc, "constant id out of range.");
+            }
+        }
+
+        void expect_slot(int pc, const Codegen::Locator& arg, int height) const {
+            if (arg.id < 0 || arg.id >= height) {
+                fail_verify(m_func_id, pc, "stack slot out of range.");
+            }
+        }
+
+        void expect_func(int pc, const Codegen::Locator& arg) const {
+            if (arg.id < 0 || arg.id >= static_cast<int>(m_arities.size())) {
+                fail_verify(m_func_id, pc, "function id out of range.");
+            }
+        }
+
+        /// @note Functions nobody calls never run, so their argument count stays unknown and their argument reads go unchecked.
+        void expect_arg(int pc, const Codegen::Locator& arg) const {
+            if (const auto arity = m_arities[m_func_id]; arg.id < 0 || (arity != unknown_arity && arg.id >= arity)) {
+                fail_verify(m_func_id, pc, "argument id out of range.");
+            }
+        }
+
+        /// @note Operands of fused instructions, see `VM::read_operand`.
+        void expect_operand(int pc, const Codegen::Locator& arg, int height) const {
+            switch (arg.region) {
+            case Codegen::Region::consts:
+                expect_const(pc, arg);
+                break;
+            case Codegen::Region::frame_slot:
+                expect_arg(pc, arg);
+                break;
+            case Codegen::Region::temp_stack:
+                expect_slot(pc, arg, height);
+                break;
+            default:
+                fail_verify(m_func_id, pc, "illegal operand region.");
+            }
+        }
+
+        void expect_push_source(int pc, const Codegen::Locator& arg, int height) const {
+            if (arg.region == Codegen::Region::routines) {
+                expect_func(pc, arg);
+            } else {
+                expect_operand(pc, arg, height);
+            }
+        }
+
+        void check_instruction(int pc, int height, int peak_height) {
+            const auto& [args, op, next] = m_code[pc];
+            const auto delta = opcode_stack_deltas[static_cast<std::size_t>(op)];
+            auto next_height = height + delta;
+            auto next_peak = peak_height + delta;
+
+            switch (op) {
+            case Opcode::xop_halt:
+            case Opcode::xop_make_array:
+            case Opcode::xop_make_tuple:
+            case Opcode::xop_access_field:
+                /// NOTE: these stop the VM with a fault, so nothing after them is reached.
+                return;
+            case Opcode::xop_noop:
+                break;
+            case Opcode::xop_replace:
+                if (args[0].region != Codegen::Region::temp_stack) {
+                    fail_verify(m_func_id, pc, "REPLACE needs a stack locator.");
+                }
+
+                expect_temps(pc, height, 1);
+                expect_slot(pc, args[0], height);
+                break;
+            case Opcode::xop_push:
+            case Opcode::xop_peek:
+                expect_push_source(pc, args[0], height);
+                break;
+            case Opcode::xop_pop:
+                expect_temps(pc, height, args[0].id);
+                next_height = height - args[0].id;
+                next_peak = peak_height - args[0].id;
+                break;
+            case Opcode::xop_load_const:
+                expect_const(pc, args[0]);
+                break;
+            case Opcode::xop_negate:
+                expect_temps(pc, height, 1);
+                break;
+            case Opcode::xop_jump:
+                flow_to(pc, args[0].id, height, peak_height);
+                return;
+            case Opcode::xop_jump_if:
+            case Opcode::xop_jump_not_if:
+                expect_temps(pc, height, 1);
+                flow_to(pc, args[0].id, next_height, next_peak);
+                break;
+            case Opcode::xop_ret:
+                if (args[0].region == Codegen::Region::routines) {
+                    expect_func(pc, args[0]);
+                } else if (args[0].region != Codegen::Region::none && args[0].region != Codegen::Region::obj_heap) {
+                    expect_operand(pc, args[0], height);
+                }
+                return;
+            case Opcode::xop_call:
+            case Opcode::xop_tail_call:
+                expect_func(pc, args[0]);
+                expect_temps(pc, height, args[1].id);
+
+                if (op == Opcode::xop_tail_call) {
+                    return;
+                }
+
+                next_height -= args[1].id;
+                next_peak -= args[1].id;
+                break;
+            case Opcode::xop_call_native:
+                if (args[1].id < 0 || args[1].id >= m_natives_n) {
+                    fail_verify(m_func_id, pc, "native id out of range.");
+                }
+
+                expect_temps(pc, height, args[2].id);
+                next_height -= args[2].id;
+                next_peak -= args[2].id;
+                break;
+            case Opcode::xop_add_i32_store:
+            case Opcode::xop_sub_i32_store:
+            case Opcode::xop_mul_i32_store:
+            case Opcode::xop_add_f32_store:
+            case Opcode::xop_sub_f32_store:
+            case Opcode::xop_mul_f32_store:
+                expect_slot(pc, args[0], height);
+                expect_operand(pc, args[1], height);
+                expect_operand(pc, args[2], height);
+                break;
+            case Opcode::xop_jump_not_eq_i32:
+            case Opcode::xop_jump_not_ne_i32:
+            case Opcode::xop_jump_not_lt_i32:
+            case Opcode::xop_jump_not_gt_i32:
+            case Opcode::xop_jump_not_eq_f32:
+            case Opcode::xop_jump_not_ne_f32:
+            case Opcode::xop_jump_not_lt_f32:
+            case Opcode::xop_jump_not_gt_f32:
+                expect_operand(pc, args[1], height);
+                expect_operand(pc, args[2], height);
+                flow_to(pc, args[0].id, height, peak_height);
+                break;
+            case Opcode::xop_push_local:
+                expect_slot(pc, args[0], height);
+                break;
+            case Opcode::xop_push_arg:
+                expect_arg(pc, args[0]);
+                break;
+            case Opcode::xop_push_func:
+                expect_func(pc, args[0]);
+                break;
+            default:
+                if (!is_binary_opcode(op)) {
+                    fail_verify(m_func_id, pc, "illegal opcode.");
+                }
+
+                expect_temps(pc, height, 2);
+                break;
+            }
+
+            flow_to(pc, next, next_height, next_peak);
+        }
+
+        const InstructionStore& m_code;
+        std::span<const int> m_arities;
+        std::vector<int> m_heights;
+        std::vector<int> m_peak_heights;
+        std::vector<int> m_worklist;
+        int m_consts_n;
+        int m_natives_n;
+        int m_func_id;
+        /// @note One more than the recorded max stack depth, as heights count the callee reference.
+        int m_height_limit;
+    };
+
+    void verify_program(std::span<const InstructionStore> funcs, std::span<const ChunkView> views, int entry_id, int native_count) {
+        const auto funcs_n = static_cast<int>(funcs.size());
+
+        if (entry_id < 0 || entry_id >= funcs_n) {
+            throw std::runtime_error {"Bytecode verification failed: entry function id out of range."};
+        }
+
+        /// NOTE: argument counts come from the call sites, as chunks do not record their arity.
+        std::vector<int> arities (funcs.size(), unknown_arity);
+        arities[entry_id] = 0;
+
+        for (auto func_id = 0; func_id < funcs_n; ++func_id) {
+            const auto code_n = static_cast<int>(funcs[func_id].size());
+
+            for (auto pc = 0; pc < code_n; ++pc) {
+                const auto& [args, op, next] = funcs[func_id][pc];
+
+                if (op != Opcode::xop_call && op != Opcode::xop_tail_call) {
+                    continue;
+                }
+
+                const auto callee_id = args[0].id;
+                const auto argc = args[1].id;
+
+                if (callee_id < 0 || callee_id >= funcs_n) {
+                    fail_verify(func_id, pc, "function id out of range.");
+                }
+
+                if (argc < 0 || (arities[callee_id] != unknown_arity && arities[callee_id] != argc)) {
+                    fail_verify(func_id, pc, "argument count disagrees with other calls of the callee.");
+                }
+
+                arities[callee_id] = argc;
+            }
+        }
+
+        for (auto func_id = 0; func_id < funcs_n; ++func_id) {
+            /// NOTE: heights count the callee reference on top of the recorded depth, so the limit is summed wide before it is narrowed back.
+            const auto height_limit = std::int64_t {1} + views[func_id].max_stack_depth;
+
+            if (views[func_id].max_stack_depth < 0) {
+                fail_verify(func_id, 0, "negative max stack depth.");
+            }
+
+            if (height_limit > std::numeric_limits<int>::max()) {
+                fail_verify(func_id, 0, "max stack depth out of range.");
+            }
+
+            ChunkVerifier verifier {funcs[func_id], static_cast<int>(views[func_id].constants.size()), native_count, arities, func_id, static_cast<int>(height_limit)};
+
+            verifier();
+        }
+    }
+}
@@ -1,149 +1,936 @@
-#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <functional>
+#include <type_traits>
 #include <utility>
+#include "vm/decoder.hpp"
+#include "vm/lowering.hpp"
+#include "vm/verifier.hpp"
 #include "vm/vm.hpp"
 
 namespace XLang::VM {
-    static constexpr auto opcode_stride = 1;
-    static constexpr auto opcode_arg_stride = 5;
-    static constexpr Codegen::Locator placeholder_arg {Codegen::Region::none, -1}; 
+    template <typename Operand>
+    [[nodiscard]] static constexpr Operand unbox_as(const Value& value) noexcept {
+        if constexpr (std::is_same_v<Operand, int>) {
+            return value.as_int();
+        } else {
+            return value.as_float();
+        }
+    }
+
+    template <typename Operand, typename Operation>
+    void VM::handle_typed_binary(Operation operation) noexcept {
+        const auto lhs = unbox_as<Operand>(m_values.back());
+        m_values.pop_back();
+
+        auto& rhs_slot = m_values.back();
+        rhs_slot = Value {operation(lhs, unbox_as<Operand>(rhs_slot))};
+    }
+
+    template <typename Operand, typename Operation>
+    void VM::handle_fused_store(const Codegen::Locator& dst, const Codegen::Locator& lhs, const Codegen::Locator& rhs, Operation operation) noexcept {
+        const auto result = operation(unbox_as<Operand>(read_operand(lhs)), unbox_as<Operand>(read_operand(rhs)));
+
+        m_values[current_frame().callee_frame_base + dst.id] = Value {result};
+    }
+
+    template <typename Operand, typename Operation>
+    void VM::handle_fused_branch(const Codegen::Locator& target, const Codegen::Locator& lhs, const Codegen::Locator& rhs, Operation operation, int next_pos) noexcept {
+        const bool check = operation(unbox_as<Operand>(read_operand(lhs)), unbox_as<Operand>(read_operand(rhs)));
+
+        m_iptr = check ? next_pos : target.id;
+    }
 
-    static auto decode_i32 = [] [[nodiscard]] (const std::vector<RuntimeByte>& code_buffer, int position) noexcept {
-        const auto result_0 = code_buffer[position] & 0x000000ff;
-        const auto result_1 = (code_buffer[position + 1] & 0x0000ff00) >> 8;
-        const auto result_2 = (code_buffer[position + 2] & 0x00ff0000) >> 16;
-        const auto result_3 = (code_buffer[position + 3] & 0xff000000) >> 24;
+    template <typename Operand, typename Operation>
+    void VM::handle_reg_typed(const std::array<Codegen::Locator, 3>& args, Operation operation) noexcept {
+        const auto result = operation(unbox_as<Operand>(read_register_operand(args[1])), unbox_as<Operand>(read_register_operand(args[2])));
 
-        return result_0 + result_1 + result_2 + result_3;
-    };
+        register_at(args[0]) = Value {result};
+    }
+
+    template <typename Operand>
+    void VM::handle_reg_divide(const std::array<Codegen::Locator, 3>& args) noexcept {
+        const auto lhs = unbox_as<Operand>(read_register_operand(args[1]));
+        const auto rhs = unbox_as<Operand>(read_register_operand(args[2]));
+
+        if (rhs == Operand {}) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Cannot divide by zero!");
+            register_at(args[0]) = Value {};
+            return;
+        }
+
+        register_at(args[0]) = Value {lhs / rhs};
+    }
+
+    template <typename Operand, typename Operation>
+    void VM::handle_reg_branch(const std::array<Codegen::Locator, 3>& args, Operation operation, int next_pos) noexcept {
+        const bool check = operation(unbox_as<Operand>(read_register_operand(args[1])), unbox_as<Operand>(read_register_operand(args[2])));
+
+        m_iptr = check ? next_pos : args[0].id;
+    }
+
+    /// @note Guard-page mode maps a region per stack. Otherwise the stacks use the heap and get null.
+    template <typename Elem>
+    [[nodiscard]] static std::unique_ptr<GuardedRegion> make_stack_region(int limit, bool guard_pages) {
+        if (!guard_pages || !GuardedRegion::is_supported_host()) {
+            return {};
+        }
+
+        return std::make_unique<GuardedRegion>(static_cast<std::size_t>(limit), sizeof(Elem));
+    }
+
+    /// @note A guarded stack reserves its whole region, guard page included, so it faults on the guard before it could reallocate.
+    template <typename Elem>
+    [[nodiscard]] static std::size_t stack_capacity(const GuardedRegion* region, int limit) noexcept {
+        return (region != nullptr) ? region->mapped_bytes() / sizeof(Elem) : static_cast<std::size_t>(limit);
+    }
+
+    VM::VM(XpliceProgram prgm, EngineKind engine, bool use_jit, StackConfig stack_config, int native_count)
+    : m_program_funcs {std::move(prgm)}, m_image {}, m_func_views {}, m_decoded_funcs {}, m_register_counts {}, m_stack_pcs {}, m_frame_sizes {}, m_native_funcs {}, m_jit {}, m_profiler {}, m_call_counts {}, m_stack_config {stack_config}, m_frame_region {make_stack_region<CallFrame>(stack_config.call_depth_limit, stack_config.guard_pages)}, m_value_region {make_stack_region<Value>(stack_config.value_stack_limit, stack_config.guard_pages)}, m_frames {StackAllocator<CallFrame> {m_frame_region.get()}}, m_values {StackAllocator<Value> {m_value_region.get()}}, m_code {nullptr}, m_consts {nullptr}, m_frame_base {0}, m_fault {}, m_iptr {0}, m_exit_status {Errcode::xerr_normal}, m_engine {engine} {
+        m_func_views.reserve(m_program_funcs.func_chunks.size());
+
+        for (const auto& func : m_program_funcs.func_chunks) {
+            m_func_views.emplace_back(func.view_code().view());
+        }
+
+        load_functions(m_program_funcs.entry_func_id, use_jit, native_count);
+    }
+
+    VM::VM(XpcImage image, EngineKind engine, bool use_jit, StackConfig stack_config, int native_count)
+    : m_program_funcs {}, m_image {std::move(image)}, m_func_views {m_image.functions()}, m_decoded_funcs {}, m_register_counts {}, m_stack_pcs {}, m_frame_sizes {}, m_native_funcs {}, m_jit {}, m_profiler {}, m_call_counts {}, m_stack_config {stack_config}, m_frame_region {make_stack_region<CallFrame>(stack_config.call_depth_limit, stack_config.guard_pages)}, m_value_region {make_stack_region<Value>(stack_config.value_stack_limit, stack_config.guard_pages)}, m_frames {StackAllocator<CallFrame> {m_frame_region.get()}}, m_values {StackAllocator<Value> {m_value_region.get()}}, m_code {nullptr}, m_consts {nullptr}, m_frame_base {0}, m_fault {}, m_iptr {0}, m_exit_status {Errcode::xerr_normal}, m_engine {engine} {
+        load_functions(m_image.entry_func_id(), use_jit, native_count);
+    }
+
+    void VM::load_functions(int entry_id, bool use_jit, int native_count) {
+        /// NOTE: decode every chunk once here so that dispatch never touches raw bytecode.
+        m_decoded_funcs.reserve(m_func_views.size());
+
+        for (const auto& func_view : m_func_views) {
+            m_decoded_funcs.emplace_back(decode_chunk(func_view));
+        }
+
+        /// NOTE: handlers trust operand regions, ids, and stack heights from here on, so nothing unverified may run.
+        verify_program(m_decoded_funcs, m_func_views, entry_id, native_count);
+
+        const auto with_jit = use_jit && TemplateJit::is_supported_host();
+        std::vector<RegisterCode> lowered_funcs;
+
+        /// NOTE: the register engine and the JIT both work on the functions lowered to three-address form.
+        if (m_engine == EngineKind::xek_register || with_jit) {
+            lowered_funcs.reserve(m_decoded_funcs.size());
+
+            for (const auto& func_code : m_decoded_funcs) {
+                lowered_funcs.emplace_back(lower_to_registers(func_code));
+            }
+        }
+
+        if (m_engine == EngineKind::xek_register) {
+            m_register_counts.reserve(m_decoded_funcs.size());
+            m_stack_pcs.reserve(m_decoded_funcs.size());
+
+            for (std::size_t func_idx = 0; func_idx < m_decoded_funcs.size(); ++func_idx) {
+                m_decoded_funcs[func_idx] = lowered_funcs[func_idx].code;
+                m_register_counts.push_back(lowered_funcs[func_idx].register_count);
+                m_stack_pcs.push_back(lowered_funcs[func_idx].stack_pcs);
+            }
+        }
+
+        m_frame_sizes.reserve(m_decoded_funcs.size());
+
+        for (std::size_t func_idx = 0; func_idx < m_decoded_funcs.size(); ++func_idx) {
+            m_frame_sizes.push_back((m_engine == EngineKind::xek_register) ? m_register_counts[func_idx] : 1 + m_func_views[func_idx].max_stack_depth);
+        }
+
+        /// NOTE: reserve both stacks once, so no push or call ever copies them mid-run. Untouched pages are never committed.
+        m_values.reserve(stack_capacity<Value>(m_value_region.get(), m_stack_config.value_stack_limit));
+        m_frames.reserve(stack_capacity<CallFrame>(m_frame_region.get(), m_stack_config.call_depth_limit));
+
+        if (with_jit) {
+            m_jit = std::make_unique<TemplateJit>(m_func_views, std::move(lowered_funcs), m_stack_config);
+            m_call_counts.assign(m_decoded_funcs.size(), 0);
+        }
 
-    VM::VM(XpliceProgram prgm) noexcept
-    : m_program_funcs {std::move(prgm)}, m_native_funcs {}, m_frames {}, m_values {}, m_iptr {0}, m_exit_status {Errcode::xerr_normal} {
         /// NOTE: VM starts execution at main function / entry point... place main on the stack as a base for the call frame values.
         m_values.emplace_back(Value {Codegen::Locator {
             .region = Codegen::Region::routines,
-            .id = m_program_funcs.entry_func_id
+            .id = entry_id
         }});
 
-        m_frames.emplace_back(
-            ArgStore {},
-            m_program_funcs.entry_func_id,
-            m_iptr,
-            0
-        );
-    }
+        m_frames.emplace_back(CallFrame {
+            .code = m_decoded_funcs[entry_id].data(),
+            .constants = m_func_views[entry_id].constants.data(),
+            .callee_id = entry_id,
+            .callee_pos = m_iptr,
+            .callee_frame_base = 0,
+            .result_slot = 0
+        });
 
-    Errcode VM::run() {
-        auto op = Opcode::xop_noop;
-        auto op_arity = 0;
-        std::array<Codegen::Locator, 3> op_args = {
-            placeholder_arg,
-            placeholder_arg,
-            placeholder_arg
-        };
+        if (m_engine == EngineKind::xek_register) {
+            m_values.resize(m_register_counts[entry_id]);
+        }
 
-        while (!is_done()) {
-            op = decode_opcode();
-            op_arity = opcode_arity[static_cast<unsigned int>(op)];
+        refresh_active_frame();
+    }
 
-            switch (op_arity) {
-            case 1:
-                op_args[0] = decode_arg(0);
-                break;
-            case 2:
-                op_args[0] = decode_arg(0);
-                op_args[1] = decode_arg(1);
-                break;
-            case 3:
-                op_args[0] = decode_arg(0);
-                op_args[1] = decode_arg(1);
-                op_args[2] = decode_arg(2);
-                break;    
-            case 0:
-            default:
-                break;
-            }
+    template <typename Profiler>
+    void VM::dispatch_switch(Profiler& profiler) {
+        /// NOTE: handlers record faults without stopping, so the status is only checked where control flow can repeat or leave the frame.
+        for (;;) {
+            const auto& [op_args, op, op_next] = fetch_instruction();
+
+            profiler.on_instruction(current_frame().callee_id, op);
 
             switch (op) {
             case Opcode::xop_halt:
-                m_exit_status = Errcode::xerr_general;
-                throw std::runtime_error {"Reached premature halt!"};
-                break;
+                raise_fault(Errcode::xerr_general, "Reached premature halt!");
+                return;
             case Opcode::xop_noop:
-                ++m_iptr;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_replace:
                 handle_replace(op_args[0]);
-                m_iptr += 6;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_push:
                 handle_push(op_args[0]);
-                m_iptr += 6; // stride of unary instruction
+                m_iptr = op_next;
                 break;
             case Opcode::xop_pop:
                 handle_pop(op_args[0]);
-                m_iptr += 6;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_peek:
                 handle_peek(op_args[0]);
-                m_iptr += 6;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_load_const:
                 handle_load_const(op_args[0]);
-                m_iptr += 6;
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_push_local:
+                handle_push_local(op_args[0]);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_push_arg:
+                handle_push_arg(op_args[0]);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_push_func:
+                handle_push_func(op_args[0]);
+                m_iptr = op_next;
                 break;
             case Opcode::xop_make_array:
             case Opcode::xop_make_tuple:
             case Opcode::xop_access_field:
-                m_exit_status = Errcode::xerr_general;
-                throw std::runtime_error {"Unsupported opcode."};
-                break;
+                raise_fault(Errcode::xerr_general, "Unsupported opcode.");
+                return;
             case Opcode::xop_negate:
                 handle_negate();
-                ++m_iptr; // stride of no-arg instruction
+                m_iptr = op_next;
                 break;
             case Opcode::xop_add:
             case Opcode::xop_sub:
             case Opcode::xop_mul:
             case Opcode::xop_div:
                 handle_arithmetic(op);
-                ++m_iptr;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_cmp_eq:
             case Opcode::xop_cmp_ne:
             case Opcode::xop_cmp_lt:
             case Opcode::xop_cmp_gt:
                 handle_compare(op);
-                ++m_iptr;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_log_and:
             case Opcode::xop_log_or:
                 handle_logical(op);
-                ++m_iptr;
+                m_iptr = op_next;
                 break;
             case Opcode::xop_jump:
                 m_iptr = op_args[0].id;
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
                 break;
             case Opcode::xop_jump_not_if:
-                handle_jump_not_if(op_args[0]);
+                handle_jump_not_if(op_args[0], op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
                 break;
             case Opcode::xop_ret:
                 handle_return(op_args[0]);
+                if (is_done() || has_fault()) {
+                    return;
+                }
                 break;
             case Opcode::xop_call:
-                handle_call(op_args[0], op_args[1].id);
+                handle_call(op_args[0], op_args[1].id, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_tail_call:
+                handle_tail_call(op_args[0], op_args[1].id);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
                 break;
             case Opcode::xop_call_native:
                 handle_native_call(op_args[0].id, op_args[1].id, op_args[2].id);
+                m_iptr = op_next;
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_add_i32:
+                handle_typed_binary<int>(std::plus<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_sub_i32:
+                handle_typed_binary<int>(std::minus<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_mul_i32:
+                handle_typed_binary<int>(std::multiplies<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_div_i32:
+                handle_divide_i32();
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_add_f32:
+                handle_typed_binary<float>(std::plus<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_sub_f32:
+                handle_typed_binary<float>(std::minus<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_mul_f32:
+                handle_typed_binary<float>(std::multiplies<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_div_f32:
+                handle_divide_f32();
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_eq_i32:
+                handle_typed_binary<int>(std::equal_to<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_ne_i32:
+                handle_typed_binary<int>(std::not_equal_to<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_lt_i32:
+                handle_typed_binary<int>(std::less<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_gt_i32:
+                handle_typed_binary<int>(std::greater<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_eq_f32:
+                handle_typed_binary<float>(std::equal_to<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_ne_f32:
+                handle_typed_binary<float>(std::not_equal_to<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_lt_f32:
+                handle_typed_binary<float>(std::less<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_gt_f32:
+                handle_typed_binary<float>(std::greater<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_add_i32_store:
+                handle_fused_store<int>(op_args[0], op_args[1], op_args[2], std::plus<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_sub_i32_store:
+                handle_fused_store<int>(op_args[0], op_args[1], op_args[2], std::minus<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_mul_i32_store:
+                handle_fused_store<int>(op_args[0], op_args[1], op_args[2], std::multiplies<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_add_f32_store:
+                handle_fused_store<float>(op_args[0], op_args[1], op_args[2], std::plus<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_sub_f32_store:
+                handle_fused_store<float>(op_args[0], op_args[1], op_args[2], std::minus<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_mul_f32_store:
+                handle_fused_store<float>(op_args[0], op_args[1], op_args[2], std::multiplies<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_jump_not_eq_i32:
+                handle_fused_branch<int>(op_args[0], op_args[1], op_args[2], std::equal_to<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_ne_i32:
+                handle_fused_branch<int>(op_args[0], op_args[1], op_args[2], std::not_equal_to<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_lt_i32:
+                handle_fused_branch<int>(op_args[0], op_args[1], op_args[2], std::less<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_gt_i32:
+                handle_fused_branch<int>(op_args[0], op_args[1], op_args[2], std::greater<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_eq_f32:
+                handle_fused_branch<float>(op_args[0], op_args[1], op_args[2], std::equal_to<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_ne_f32:
+                handle_fused_branch<float>(op_args[0], op_args[1], op_args[2], std::not_equal_to<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_lt_f32:
+                handle_fused_branch<float>(op_args[0], op_args[1], op_args[2], std::less<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_gt_f32:
+                handle_fused_branch<float>(op_args[0], op_args[1], op_args[2], std::greater<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
                 break;
             default:
-                m_exit_status = Errcode::xerr_general;
-                throw std::runtime_error {"Illegal opcode read."};
+                /// NOTE: decoding rejects illegal opcodes, so the compiler may drop its range check on this switch.
+                std::unreachable();
+            }
+        }
+    }
+
+    template <typename Profiler>
+    void VM::dispatch_registers(Profiler& profiler) {
+        /// NOTE: handlers record faults without stopping, so the status is only checked where control flow can repeat or leave the frame.
+        for (;;) {
+            const auto& [op_args, op, op_next] = fetch_instruction();
+
+            profiler.on_instruction(current_frame().callee_id, op);
+
+            switch (op) {
+            case Opcode::xop_replace:
+                register_at(op_args[0]) = read_register_operand(op_args[1]);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_push:
+                register_at(op_args[0]) = Value {op_args[1]};
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_negate:
+                handle_reg_negate(op_args);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_add:
+            case Opcode::xop_sub:
+            case Opcode::xop_mul:
+            case Opcode::xop_div:
+            case Opcode::xop_cmp_eq:
+            case Opcode::xop_cmp_ne:
+            case Opcode::xop_cmp_lt:
+            case Opcode::xop_cmp_gt:
+            case Opcode::xop_log_and:
+            case Opcode::xop_log_or:
+                handle_reg_generic(op, op_args);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_jump:
+                m_iptr = op_args[0].id;
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_if:
+                handle_reg_jump_not_if(op_args, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_ret:
+                handle_reg_return(op_args[0]);
+                if (is_done() || has_fault()) {
+                    return;
+                }
+                break;
+            case Opcode::xop_call:
+                handle_reg_call(op_args, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_tail_call:
+                handle_reg_tail_call(op_args);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_call_native:
+                handle_reg_native_call(op_args);
+                m_iptr = op_next;
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_div_i32:
+                handle_reg_divide<int>(op_args);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_div_f32:
+                handle_reg_divide<float>(op_args);
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_add_i32_store:
+                handle_reg_typed<int>(op_args, std::plus<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_sub_i32_store:
+                handle_reg_typed<int>(op_args, std::minus<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_mul_i32_store:
+                handle_reg_typed<int>(op_args, std::multiplies<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_add_f32_store:
+                handle_reg_typed<float>(op_args, std::plus<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_sub_f32_store:
+                handle_reg_typed<float>(op_args, std::minus<float> {});
+                m_iptr = op_next;
                 break;
+            case Opcode::xop_mul_f32_store:
+                handle_reg_typed<float>(op_args, std::multiplies<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_eq_i32:
+                handle_reg_typed<int>(op_args, std::equal_to<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_ne_i32:
+                handle_reg_typed<int>(op_args, std::not_equal_to<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_lt_i32:
+                handle_reg_typed<int>(op_args, std::less<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_gt_i32:
+                handle_reg_typed<int>(op_args, std::greater<int> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_eq_f32:
+                handle_reg_typed<float>(op_args, std::equal_to<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_ne_f32:
+                handle_reg_typed<float>(op_args, std::not_equal_to<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_lt_f32:
+                handle_reg_typed<float>(op_args, std::less<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_cmp_gt_f32:
+                handle_reg_typed<float>(op_args, std::greater<float> {});
+                m_iptr = op_next;
+                break;
+            case Opcode::xop_jump_not_eq_i32:
+                handle_reg_branch<int>(op_args, std::equal_to<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_ne_i32:
+                handle_reg_branch<int>(op_args, std::not_equal_to<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_lt_i32:
+                handle_reg_branch<int>(op_args, std::less<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_gt_i32:
+                handle_reg_branch<int>(op_args, std::greater<int> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_eq_f32:
+                handle_reg_branch<float>(op_args, std::equal_to<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_ne_f32:
+                handle_reg_branch<float>(op_args, std::not_equal_to<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_lt_f32:
+                handle_reg_branch<float>(op_args, std::less<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_jump_not_gt_f32:
+                handle_reg_branch<float>(op_args, std::greater<float> {}, op_next);
+                if (has_fault()) [[unlikely]] {
+                    return;
+                }
+                break;
+            case Opcode::xop_halt:
+                raise_fault(Errcode::xerr_general, "Reached premature halt!");
+                return;
+            default:
+                raise_fault(Errcode::xerr_general, "Unsupported opcode for the register engine.");
+                return;
+            }
+        }
+    }
+
+#if XLANG_THREADED_DISPATCH
+/// NOTE: labels-as-values is a GNU extension, so silence the pedantic diagnostics just for this engine.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wgnu-label-as-value"
+#endif
+    void VM::dispatch_threaded() {
+        static const std::array<void*, static_cast<std::size_t>(Opcode::last)> dispatch_table = {
+            &&op_halt,
+            &&op_noop,
+            &&op_replace,
+            &&op_push,
+            &&op_pop,
+            &&op_peek,
+            &&op_load_const,
+            &&op_unsupported,
+            &&op_unsupported,
+            &&op_unsupported,
+            &&op_negate,
+            &&op_arithmetic,
+            &&op_arithmetic,
+            &&op_arithmetic,
+            &&op_arithmetic,
+            &&op_compare,
+            &&op_compare,
+            &&op_compare,
+            &&op_compare,
+            &&op_logical,
+            &&op_logical,
+            &&op_jump,
+            &&op_illegal,
+            &&op_jump_not_if,
+            &&op_ret,
+            &&op_call,
+            &&op_call_native,
+            &&op_add_i32,
+            &&op_sub_i32,
+            &&op_mul_i32,
+            &&op_div_i32,
+            &&op_add_f32,
+            &&op_sub_f32,
+            &&op_mul_f32,
+            &&op_div_f32,
+            &&op_cmp_eq_i32,
+            &&op_cmp_ne_i32,
+            &&op_cmp_lt_i32,
+            &&op_cmp_gt_i32,
+            &&op_cmp_eq_f32,
+            &&op_cmp_ne_f32,
+            &&op_cmp_lt_f32,
+            &&op_cmp_gt_f32,
+            &&op_add_i32_store,
+            &&op_sub_i32_store,
+            &&op_mul_i32_store,
+            &&op_add_f32_store,
+            &&op_sub_f32_store,
+            &&op_mul_f32_store,
+            &&op_jump_not_eq_i32,
+            &&op_jump_not_ne_i32,
+            &&op_jump_not_lt_i32,
+            &&op_jump_not_gt_i32,
+            &&op_jump_not_eq_f32,
+            &&op_jump_not_ne_f32,
+            &&op_jump_not_lt_f32,
+            &&op_jump_not_gt_f32,
+            &&op_push_local,
+            &&op_push_arg,
+            &&op_push_func,
+            &&op_tail_call
+        };
+
+        const Instruction* instr = nullptr;
+
+/// NOTE: each handler ends in its own copy of this indirect jump, giving the branch predictor one site per opcode.
+#define XLANG_DISPATCH_NEXT() \
+    instr = &fetch_instruction(); \
+    goto *dispatch_table[static_cast<std::size_t>(instr->op)]
+
+/// NOTE: handlers record faults without stopping, so only branch points pay for this check.
+#define XLANG_DISPATCH_BRANCH() \
+    if (has_fault()) [[unlikely]] { \
+        return; \
+    } \
+    XLANG_DISPATCH_NEXT()
+
+        XLANG_DISPATCH_NEXT();
+
+    op_halt:
+        raise_fault(Errcode::xerr_general, "Reached premature halt!");
+        return;
+    op_noop:
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_replace:
+        handle_replace(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_push:
+        handle_push(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_pop:
+        handle_pop(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_peek:
+        handle_peek(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_load_const:
+        handle_load_const(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_push_local:
+        handle_push_local(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_push_arg:
+        handle_push_arg(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_push_func:
+        handle_push_func(instr->args[0]);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_unsupported:
+        raise_fault(Errcode::xerr_general, "Unsupported opcode.");
+        return;
+    op_negate:
+        handle_negate();
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_arithmetic:
+        handle_arithmetic(instr->op);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_compare:
+        handle_compare(instr->op);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_logical:
+        handle_logical(instr->op);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_jump:
+        m_iptr = instr->args[0].id;
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_if:
+        handle_jump_not_if(instr->args[0], instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_ret:
+        handle_return(instr->args[0]);
+
+        /// NOTE: only a return can empty the call stack, so this is the sole exit check.
+        if (is_done() || has_fault()) {
+            return;
+        }
+
+        XLANG_DISPATCH_NEXT();
+    op_call:
+        handle_call(instr->args[0], instr->args[1].id, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_tail_call:
+        handle_tail_call(instr->args[0], instr->args[1].id);
+        XLANG_DISPATCH_BRANCH();
+    op_call_native:
+        handle_native_call(instr->args[0].id, instr->args[1].id, instr->args[2].id);
+        m_iptr = instr->next;
+        XLANG_DISPATCH_BRANCH();
+    op_add_i32:
+        handle_typed_binary<int>(std::plus<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_sub_i32:
+        handle_typed_binary<int>(std::minus<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_mul_i32:
+        handle_typed_binary<int>(std::multiplies<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_div_i32:
+        handle_divide_i32();
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_add_f32:
+        handle_typed_binary<float>(std::plus<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_sub_f32:
+        handle_typed_binary<float>(std::minus<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_mul_f32:
+        handle_typed_binary<float>(std::multiplies<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_div_f32:
+        handle_divide_f32();
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_eq_i32:
+        handle_typed_binary<int>(std::equal_to<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_ne_i32:
+        handle_typed_binary<int>(std::not_equal_to<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_lt_i32:
+        handle_typed_binary<int>(std::less<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_gt_i32:
+        handle_typed_binary<int>(std::greater<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_eq_f32:
+        handle_typed_binary<float>(std::equal_to<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_ne_f32:
+        handle_typed_binary<float>(std::not_equal_to<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_lt_f32:
+        handle_typed_binary<float>(std::less<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_cmp_gt_f32:
+        handle_typed_binary<float>(std::greater<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_add_i32_store:
+        handle_fused_store<int>(instr->args[0], instr->args[1], instr->args[2], std::plus<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_sub_i32_store:
+        handle_fused_store<int>(instr->args[0], instr->args[1], instr->args[2], std::minus<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_mul_i32_store:
+        handle_fused_store<int>(instr->args[0], instr->args[1], instr->args[2], std::multiplies<int> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_add_f32_store:
+        handle_fused_store<float>(instr->args[0], instr->args[1], instr->args[2], std::plus<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_sub_f32_store:
+        handle_fused_store<float>(instr->args[0], instr->args[1], instr->args[2], std::minus<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_mul_f32_store:
+        handle_fused_store<float>(instr->args[0], instr->args[1], instr->args[2], std::multiplies<float> {});
+        m_iptr = instr->next;
+        XLANG_DISPATCH_NEXT();
+    op_jump_not_eq_i32:
+        handle_fused_branch<int>(instr->args[0], instr->args[1], instr->args[2], std::equal_to<int> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_ne_i32:
+        handle_fused_branch<int>(instr->args[0], instr->args[1], instr->args[2], std::not_equal_to<int> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_lt_i32:
+        handle_fused_branch<int>(instr->args[0], instr->args[1], instr->args[2], std::less<int> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_gt_i32:
+        handle_fused_branch<int>(instr->args[0], instr->args[1], instr->args[2], std::greater<int> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_eq_f32:
+        handle_fused_branch<float>(instr->args[0], instr->args[1], instr->args[2], std::equal_to<float> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_ne_f32:
+        handle_fused_branch<float>(instr->args[0], instr->args[1], instr->args[2], std::not_equal_to<float> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_lt_f32:
+        handle_fused_branch<float>(instr->args[0], instr->args[1], instr->args[2], std::less<float> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_jump_not_gt_f32:
+        handle_fused_branch<float>(instr->args[0], instr->args[1], instr->args[2], std::greater<float> {}, instr->next);
+        XLANG_DISPATCH_BRANCH();
+    op_illegal:
+        raise_fault(Errcode::xerr_general, "Illegal opcode read.");
+        return;
+
+#undef XLANG_DISPATCH_BRANCH
+#undef XLANG_DISPATCH_NEXT
+    }
+#pragma GCC diagnostic pop
+#endif
+
+    Errcode VM::run() {
+        if (m_value_region != nullptr) {
+            const auto guard_hit = run_with_stack_guards(*m_value_region, *m_frame_region, [](void* vm_p) {
+                static_cast<VM*>(vm_p)->dispatch();
+            }, this);
+
+            /// NOTE: the faulting push was abandoned midway, so only the fault is recorded and nothing runs after it.
+            if (guard_hit == GuardHit::value_stack) {
+                raise_fault(Errcode::xerr_temp_stack, "Value stack overflow.");
+            } else if (guard_hit == GuardHit::call_stack) {
+                raise_fault(Errcode::xerr_call_stack, "Call stack overflow.");
             }
+        } else {
+            dispatch();
         }
 
         if (m_exit_status == Errcode::xerr_normal) {
-            const auto main_ret = std::get<int>(m_values.front().inner_box());
+            const auto main_ret = m_values.front().as_int();
 
             m_exit_status = (main_ret == 0) ? Errcode::xerr_normal : Errcode::xerr_general;
         }
@@ -151,16 +938,89 @@ namespace XLang::VM {
         return m_exit_status;
     }
 
-    Errcode VM::invoke_native_func(const NativeFunction& func, const ArgStore& args) {
+    void VM::dispatch() {
+        if (m_profiler) {
+            if (m_engine == EngineKind::xek_register) {
+                dispatch_registers(*m_profiler);
+            } else {
+                dispatch_switch(*m_profiler);
+            }
+
+            m_profiler->finish();
+            return;
+        }
+
+        NoProfiling no_profiling;
+
+        if (m_engine == EngineKind::xek_register) {
+            dispatch_registers(no_profiling);
+        } else {
+#if XLANG_THREADED_DISPATCH
+            dispatch_threaded();
+#else
+            dispatch_switch(no_profiling);
+#endif
+        }
+    }
+
+    Errcode VM::invoke_native_func(const NativeFunction& func, ArgView args) {
         return func.ptr()(this, args);
     }
 
     /// @note Registers a native function wrapper to the runtime. The `id` must ascend from 0 to N corresponding to the order of use-native statements!
     void VM::add_native_function(int native_id, const NativeFunction& func) noexcept {
+        if (native_id >= static_cast<int>(m_native_funcs.size())) {
+            m_native_funcs.resize(native_id + 1);
+        }
+
         m_native_funcs[native_id] = func;
     }
 
 
+    void VM::enable_profiling() {
+        m_profiler = std::make_unique<OpcodeProfiler>(static_cast<int>(m_decoded_funcs.size()));
+    }
+
+    const OpcodeProfiler* VM::profiler() const noexcept {
+        return m_profiler.get();
+    }
+
+    std::size_t VM::snapshot_call_stack(std::span<SampledFrame> out) const noexcept {
+        const auto frames_n = m_frames.size();
+        const auto kept_n = std::min(frames_n, out.size());
+        const auto first_kept = frames_n - kept_n;
+
+        for (std::size_t kept_idx = 0; kept_idx < kept_n; ++kept_idx) {
+            const auto frame_idx = first_kept + kept_idx;
+
+            /// NOTE: a caller's saved position is its return address, one past the call.
+            out[kept_idx] = {
+                .func_id = m_frames[frame_idx].callee_id,
+                .pc = (frame_idx + 1 < frames_n) ? m_frames[frame_idx].callee_pos - 1 : m_iptr
+            };
+        }
+
+        return kept_n;
+    }
+
+    std::span<const FunctionDebugInfo> VM::debug_info() const noexcept {
+        return m_program_funcs.debug_funcs;
+    }
+
+    int VM::stack_pc(int func_id, int pc) const noexcept {
+        if (m_engine != EngineKind::xek_register || func_id < 0 || static_cast<std::size_t>(func_id) >= m_stack_pcs.size()) {
+            return pc;
+        }
+
+        const auto& func_stack_pcs = m_stack_pcs[func_id];
+
+        if (pc < 0 || static_cast<std::size_t>(pc) >= func_stack_pcs.size()) {
+            return pc;
+        }
+
+        return func_stack_pcs[pc];
+    }
+
     const CallFrame& VM::current_frame() const noexcept {
         return m_frames.back();
     }
@@ -169,27 +1029,86 @@ namespace XLang::VM {
         return m_frames.empty();
     }
 
-    Opcode VM::decode_opcode() const noexcept {
-        // std::cout << "CHUNK: " << current_frame().callee_id <<  ", IPTR: " << m_iptr << '\n';
-        const auto decoded_op = m_program_funcs.func_chunks.at(current_frame().callee_id).view_code().bytecode[m_iptr];
-
-        return static_cast<Opcode>(decoded_op);
+    bool VM::has_fault() const noexcept {
+        return m_exit_status != Errcode::xerr_normal;
     }
 
-    Codegen::Locator VM::decode_arg(int arg_num) const noexcept {
-        const auto& chunk_view = m_program_funcs.func_chunks.at(current_frame().callee_id).view_code().bytecode;
-        const auto arg_byte_pos = opcode_stride + (arg_num * opcode_arg_stride);
+    void VM::raise_fault(Errcode code, const char* message) noexcept {
+        /// NOTE: keep the first fault, as later ones in the same block only see its placeholder results.
+        if (has_fault()) {
+            return;
+        }
 
-        return {
-            .region = static_cast<Codegen::Region>(
-                chunk_view[m_iptr + arg_byte_pos]
-            ),
-            .id = static_cast<int>(
-                decode_i32(chunk_view, m_iptr + arg_byte_pos + 1)
-            )
+        m_exit_status = code;
+        m_fault = FaultInfo {
+            .message = message,
+            .code = code,
+            .func_id = is_done() ? -1 : current_frame().callee_id,
+            .pc = m_iptr,
+            .frame_depth = static_cast<int>(m_frames.size()) - 1
         };
     }
 
+    const FaultInfo& VM::fault() const noexcept {
+        return m_fault;
+    }
+
+    void VM::refresh_active_frame() noexcept {
+        const auto& frame = current_frame();
+
+        m_code = frame.code;
+        m_consts = frame.constants;
+        m_frame_base = frame.callee_frame_base;
+    }
+
+    std::optional<Value> VM::try_jit_call(int callee_id, const Value* args_begin, int argc) noexcept {
+        if (!m_jit->is_compiled(callee_id)) {
+            if (auto& call_count = m_call_counts[callee_id]; call_count < TemplateJit::cm_hot_call_threshold) {
+                ++call_count;
+                return {};
+            }
+
+            /// NOTE: uncompilable functions fail here cheaply on every later call.
+            if (!m_jit->compile(callee_id)) {
+                return {};
+            }
+        }
+
+        /// NOTE: compiled code has no side effects, so a bailout just means interpreting the same call from the start.
+        const auto frames_left = m_stack_config.call_depth_limit - static_cast<int>(m_frames.size());
+        const auto values_left = m_stack_config.value_stack_limit - static_cast<int>(args_begin - m_values.data());
+
+        return m_jit->invoke(callee_id, std::span<const Value> {args_begin, static_cast<std::size_t>(argc)}, frames_left, values_left);
+    }
+
+    const Instruction& VM::fetch_instruction() const noexcept {
+        return m_code[m_iptr];
+    }
+
+    const Value& VM::read_operand(const Codegen::Locator& arg) const noexcept {
+        switch (arg.region) {
+        case Codegen::Region::consts:
+            return m_consts[arg.id];
+        case Codegen::Region::frame_slot:
+            return m_values[m_frame_base - 1 - arg.id];
+        case Codegen::Region::temp_stack:
+        default:
+            return m_values[current_frame().callee_frame_base + arg.id];
+        }
+    }
+
+    Value& VM::register_at(const Codegen::Locator& reg) noexcept {
+        return m_values[m_frame_base + reg.id];
+    }
+
+    const Value& VM::read_register_operand(const Codegen::Locator& arg) const noexcept {
+        if (arg.region == Codegen::Region::consts) {
+            return m_consts[arg.id];
+        }
+
+        return m_values[m_frame_base + arg.id];
+    }
+
     const Value& VM::peek_stack_top() const noexcept {
         return m_values.back();
     }
@@ -198,89 +1117,84 @@ namespace XLang::VM {
         m_values.emplace_back(std::move(temp));
     }
 
-    void VM::handle_halt() {
+    void VM::handle_halt() noexcept {
         m_frames.clear();
     }
 
-    void VM::handle_replace(const Codegen::Locator& arg) {
-        if (arg.region != Codegen::Region::temp_stack) {
-            m_exit_status = Errcode::xerr_temp_stack;
-            throw std::runtime_error {"Illegal argument to REPLACE instruction detected - not a stack locator."};
-        }
-
+    void VM::handle_replace(const Codegen::Locator& arg) noexcept {
         m_values[current_frame().callee_frame_base + arg.id] = m_values.back();
         m_values.pop_back();
     }
 
-    void VM::handle_push(const Codegen::Locator& arg) {
+    void VM::handle_push(const Codegen::Locator& arg) noexcept {
         switch (arg.region) {
         case Codegen::Region::consts:
-            m_values.push_back(
-                m_program_funcs.func_chunks.at(
-                    current_frame().callee_id
-                ).view_code().constants.at(arg.id)
-            );
+            m_values.push_back(m_consts[arg.id]);
             break;
         case Codegen::Region::temp_stack:
             m_values.push_back(m_values[current_frame().callee_frame_base + arg.id]);
             break;
-        case Codegen::Region::obj_heap:
-            m_exit_status = Errcode::xerr_temp_stack;
-            throw std::runtime_error {"Unimplemented push of heap object."};
-            break;
         case Codegen::Region::routines:
             m_values.push_back(Value {arg});
             break;
         case Codegen::Region::frame_slot:
-            m_values.push_back(current_frame().args[arg.id]);
+            m_values.push_back(m_values[m_frame_base - 1 - arg.id]);
             break;
-        case Codegen::Region::none:
         default:
-            m_exit_status = Errcode::xerr_temp_stack;
-            throw std::runtime_error {"Illegal push of un-tagged object detected."};
-            break;
+            /// NOTE: the verifier rejects every other push source.
+            std::unreachable();
         }
     }
 
-    void VM::handle_pop(const Codegen::Locator& arg) {
+    void VM::handle_pop(const Codegen::Locator& arg) noexcept {
         for (auto pop_count = 0; pop_count < arg.id; ++pop_count) {
             m_values.pop_back();
         }
     }
 
-    void VM::handle_peek(const Codegen::Locator& arg) {
+    void VM::handle_peek(const Codegen::Locator& arg) noexcept {
         handle_push(arg);
     }
 
-    void VM::handle_load_const(const Codegen::Locator& arg) {
-        m_values.push_back(
-            m_program_funcs.func_chunks.at(
-                current_frame().callee_id
-            ).view_code().constants.at(arg.id)
-        );
+    void VM::handle_push_local(const Codegen::Locator& arg) noexcept {
+        const auto local = m_values[m_frame_base + arg.id];
+
+        m_values.push_back(local);
+    }
+
+    void VM::handle_push_arg(const Codegen::Locator& arg) noexcept {
+        const auto param = m_values[m_frame_base - 1 - arg.id];
+
+        m_values.push_back(param);
+    }
+
+    void VM::handle_push_func(const Codegen::Locator& arg) noexcept {
+        m_values.emplace_back(arg);
     }
 
-    void VM::handle_negate() {
+    void VM::handle_load_const(const Codegen::Locator& arg) noexcept {
+        m_values.push_back(m_consts[arg.id]);
+    }
+
+    void VM::handle_negate() noexcept {
         auto arg = m_values.back();
         m_values.pop_back();
 
         if (arg.is_numeric()) {   
-            const auto& arg_boxed = arg.inner_box();
-
-            if (arg_boxed.index() == 2) {
-                m_values.emplace_back(-std::get<int>(arg_boxed));
-            } else if (arg_boxed.index() == 3) {
-                m_values.emplace_back(-std::get<float>(arg_boxed));
+            if (arg.tag() == ValueTag::primitive_int) {
+                m_values.emplace_back(-arg.as_int());
+            } else {
+                m_values.emplace_back(-arg.as_float());
             }
 
             return;
         }
 
-        m_exit_status = Errcode::xerr_arithmetic;
-        throw std::runtime_error {"Invalid negation on non-numeric Value."};
+        raise_fault(Errcode::xerr_arithmetic, "Invalid negation on non-numeric Value.");
+        m_values.emplace_back();
     }
 
-    void VM::handle_arithmetic(Opcode op) {
+    void VM::handle_arithmetic(Opcode op) noexcept {
         Value arg_lhs;
         Value arg_rhs;
 
@@ -298,9 +1212,13 @@ namespace XLang::VM {
         } else {
             m_values.emplace_back(arg_lhs.divide(arg_rhs));
         }
+
+        if (m_values.back().is_null()) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Invalid arithmetic operands: non-numeric, mismatched, or a zero divisor.");
+        }
     }
 
-    void VM::handle_compare(Opcode op) {
+    void VM::handle_compare(Opcode op) noexcept {
         Value lhs_box = m_values.back();
         m_values.pop_back();
         Value rhs_box = m_values.back();
@@ -315,9 +1233,13 @@ namespace XLang::VM {
         } else {
             m_values.emplace_back(lhs_box.compare_gt(rhs_box));
         }
+
+        if (m_values.back().is_null()) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Unsupported comparison for array / tuple.");
+        }
     }
 
-    void VM::handle_logical(Opcode op) {
+    void VM::handle_logical(Opcode op) noexcept {
         Value lhs_box = m_values.back();
         m_values.pop_back();
         Value rhs_box = m_values.back();
@@ -328,102 +1250,352 @@ namespace XLang::VM {
         } else {
             m_values.emplace_back(lhs_box.logical_or(rhs_box));
         }
+
+        if (m_values.back().is_null()) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Logical operators are unsupported for non-booleans.");
+        }
     }
 
-    void VM::handle_jump_not_if(const Codegen::Locator& arg) {
+    void VM::handle_divide_i32() noexcept {
+        const auto lhs = m_values.back().as_int();
+        m_values.pop_back();
+
+        auto& rhs_slot = m_values.back();
+        const auto rhs = rhs_slot.as_int();
+
+        if (rhs == 0) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Cannot divide by zero!");
+            rhs_slot = Value {};
+            return;
+        }
+
+        rhs_slot = Value {lhs / rhs};
+    }
+
+    void VM::handle_divide_f32() noexcept {
+        const auto lhs = m_values.back().as_float();
+        m_values.pop_back();
+
+        auto& rhs_slot = m_values.back();
+        const auto rhs = rhs_slot.as_float();
+
+        if (rhs == 0.0f) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Cannot divide by zero!");
+            rhs_slot = Value {};
+            return;
+        }
+
+        rhs_slot = Value {lhs / rhs};
+    }
+
+    void VM::handle_jump_not_if(const Codegen::Locator& arg, int next_pos) noexcept {
         Value check_val = m_values.back();
         m_values.pop_back();
 
-        if (!std::get<bool>(check_val.inner_box())) {
+        if (!check_val.as_bool()) {
             m_iptr = arg.id;
         } else {
-            m_iptr += 6; // advance past jump_if with encoded stride of 6 bytes
+            m_iptr = next_pos;
         }
     }
 
-    void VM::handle_return(const Codegen::Locator& arg) {
+    void VM::handle_return(const Codegen::Locator& arg) noexcept {
         const auto [arg_tag, arg_num] = arg;
         Value result = ([&arg, this](Codegen::Region tag, int num) {
             switch (tag) {
             case Codegen::Region::consts:
-                return m_program_funcs.func_chunks.at(
-                    current_frame().callee_id
-                ).view_code().constants.at(num);
+                return m_consts[num];
             case Codegen::Region::temp_stack:
                 return m_values[current_frame().callee_frame_base + num];
             case Codegen::Region::obj_heap:
             case Codegen::Region::routines:
                 return Value {arg};
             case Codegen::Region::frame_slot:
-                return current_frame().args[num];
+                return m_values[m_frame_base - 1 - num];
             case Codegen::Region::none:
                 return m_values.back();
             default:
-                m_exit_status = Errcode::xerr_temp_stack;
-                throw std::runtime_error {"Invalid argument tag for opcode RET: none, etc."};
-                break;
+                std::unreachable();
             }
         })(arg_tag, arg_num); // Use IIFE here for conditional multi-value setting.
 
-        while (!m_values.back().is_func_reference()) {
-            m_values.pop_back();
-        }
-        m_values.pop_back();
-
+        /// NOTE: truncate to where the arguments began, dropping the callee reference and every temporary in one step. `Value` is trivially destructible, so this is constant time.
+        m_values.resize(current_frame().result_slot);
         m_values.emplace_back(std::move(result));
 
         m_frames.pop_back();
 
         if (!is_done()) {
             m_iptr = current_frame().callee_pos;
+            refresh_active_frame();
         } else {
             m_iptr = 0;
         }
     }
 
-    void VM::handle_call(const Codegen::Locator& local_func_id, int argc) {
-        /// NOTE: store return address in caller before entering callee...
-        const auto ret_func_pos = m_iptr + opcode_stride + (2 * opcode_arg_stride);
-        m_frames.back().callee_pos = ret_func_pos;
-
-        ArgStore args;
+    bool VM::has_room_for_frame(int callee_id, int callee_base, bool adds_frame) noexcept {
+        if (adds_frame && static_cast<int>(m_frames.size()) >= m_stack_config.call_depth_limit) [[unlikely]] {
+            raise_fault(Errcode::xerr_call_stack, "Call stack overflow.");
+            return false;
+        }
 
-        for (auto arg_count = 0; arg_count < argc; ++arg_count) {
-            auto temp_arg = m_values.back();
-            args.emplace_back(std::move(temp_arg));
-            m_values.pop_back();
+        if (callee_base + m_frame_sizes[callee_id] > m_stack_config.value_stack_limit) [[unlikely]] {
+            raise_fault(Errcode::xerr_temp_stack, "Value stack overflow.");
+            return false;
         }
 
-        /// NOTE: prepare base value & call state of function frame...
+        return true;
+    }
+
+    void VM::handle_call(const Codegen::Locator& local_func_id, int argc, int ret_pos) noexcept {
         const auto base_mark = static_cast<int>(m_values.size());
+
+        if (m_jit) {
+            if (const auto jit_result = try_jit_call(local_func_id.id, m_values.data() + base_mark - argc, argc); jit_result) {
+                m_values.resize(base_mark - argc);
+                m_values.push_back(*jit_result);
+                m_iptr = ret_pos;
+                return;
+            }
+        }
+
+        if (!has_room_for_frame(local_func_id.id, base_mark, true)) {
+            return;
+        }
+
+        /// NOTE: store return address in caller before entering callee...
+        m_frames.back().callee_pos = ret_pos;
+
+        /// NOTE: prepare base value & call state of function frame, leaving the arguments in place below it...
         m_values.emplace_back(Value {Codegen::Locator {
             .region = Codegen::Region::routines,
             .id = local_func_id.id
         }});
 
+        const auto callee_id = local_func_id.id;
+
         m_frames.emplace_back(CallFrame {
-            .args = std::move(args),
-            .callee_id = local_func_id.id,
+            .code = m_decoded_funcs[callee_id].data(),
+            .constants = m_func_views[callee_id].constants.data(),
+            .callee_id = callee_id,
             .callee_pos = 0,
-            .callee_frame_base = base_mark
+            .callee_frame_base = base_mark,
+            .result_slot = base_mark - argc
         });
 
         /// NOTE: resume execution at the beginning of the callee's chunk
+        refresh_active_frame();
         m_iptr = 0;
     }
 
-    void VM::handle_native_call([[maybe_unused]] int module_id, int native_id, int argc) {
-        ArgStore args;
+    void VM::handle_tail_call(const Codegen::Locator& local_func_id, int argc) noexcept {
+        auto& frame = m_frames.back();
+        const auto args_begin = static_cast<int>(m_values.size()) - argc;
+        const auto base_mark = frame.result_slot + argc;
+        const auto callee_id = local_func_id.id;
 
-        for (auto arg_count = 0; arg_count < argc; ++arg_count) {
-            auto temp_arg = m_values.back();
-            args.emplace_back(std::move(temp_arg));
-            m_values.pop_back();
+        if (!has_room_for_frame(callee_id, base_mark, false)) {
+            return;
+        }
+
+        /// NOTE: slide the new arguments down over the old frame, which keeps them in the same order, then drop everything above them.
+        std::copy(m_values.begin() + args_begin, m_values.end(), m_values.begin() + frame.result_slot);
+        m_values.resize(base_mark);
+        m_values.emplace_back(Value {Codegen::Locator {
+            .region = Codegen::Region::routines,
+            .id = callee_id
+        }});
+
+        /// NOTE: the caller's return address and result slot carry over unchanged.
+        frame.code = m_decoded_funcs[callee_id].data();
+        frame.constants = m_func_views[callee_id].constants.data();
+        frame.callee_id = callee_id;
+        frame.callee_pos = 0;
+        frame.callee_frame_base = base_mark;
+
+        refresh_active_frame();
+        m_iptr = 0;
+    }
+
+    void VM::handle_native_call([[maybe_unused]] int module_id, int native_id, int argc) noexcept {
+        const auto args_begin = static_cast<int>(m_values.size()) - argc;
+
+        if (const auto native_status = invoke_native_in_place(native_id, args_begin, argc); native_status != Errcode::xerr_normal) [[unlikely]] {
+            raise_fault(native_status, "Native function reported an error.");
+        }
+
+        /// NOTE: the native pushed its result above the arguments, so slide it down over them.
+        const auto result = m_values.back();
+
+        m_values.resize(args_begin);
+        m_values.emplace_back(result);
+    }
+
+    Errcode VM::invoke_native_in_place(int native_id, int args_begin, int argc) noexcept {
+        /// NOTE: the native's one pushed result must not reallocate the value stack under its argument view.
+        m_values.reserve(m_values.size() + 1);
+
+        /// NOTE: natives are registered after loading, so a declared native may still be missing here. Push a placeholder result for the caller to slide down.
+        if (native_id < 0 || native_id >= static_cast<int>(m_native_funcs.size()) || m_native_funcs[native_id].ptr() == nullptr) [[unlikely]] {
+            raise_fault(Errcode::xerr_access, "Native function was never registered.");
+            m_values.emplace_back(Value {});
+            return Errcode::xerr_access;
+        }
+
+        const auto args_it = m_values.begin() + args_begin;
+
+        /// NOTE: arguments were pushed last-to-first, so flip them in place for natives to read them in source order. The callee consumes them anyway.
+        std::reverse(args_it, args_it + argc);
+
+        return m_native_funcs[native_id].invoke(*this, ArgView {std::to_address(args_it), static_cast<std::size_t>(argc)});
+    }
+
+    void VM::handle_reg_generic(Opcode op, const std::array<Codegen::Locator, 3>& args) noexcept {
+        const auto& lhs_box = read_register_operand(args[1]);
+        const auto& rhs_box = read_register_operand(args[2]);
+        Value result;
+
+        switch (op) {
+        case Opcode::xop_add: result = lhs_box.add(rhs_box); break;
+        case Opcode::xop_sub: result = lhs_box.subtract(rhs_box); break;
+        case Opcode::xop_mul: result = lhs_box.multiply(rhs_box); break;
+        case Opcode::xop_div: result = lhs_box.divide(rhs_box); break;
+        case Opcode::xop_cmp_eq: result = lhs_box.compare_eq(rhs_box); break;
+        case Opcode::xop_cmp_ne: result = lhs_box.compare_ne(rhs_box); break;
+        case Opcode::xop_cmp_lt: result = lhs_box.compare_lt(rhs_box); break;
+        case Opcode::xop_cmp_gt: result = lhs_box.compare_gt(rhs_box); break;
+        case Opcode::xop_log_and: result = lhs_box.logical_and(rhs_box); break;
+        default: result = lhs_box.logical_or(rhs_box); break;
+        }
+
+        if (result.is_null()) [[unlikely]] {
+            raise_fault(Errcode::xerr_arithmetic, "Invalid operands for a generic operation.");
+        }
+
+        register_at(args[0]) = result;
+    }
+
+    void VM::handle_reg_negate(const std::array<Codegen::Locator, 3>& args) noexcept {
+        const auto arg = read_register_operand(args[1]);
+
+        if (arg.tag() == ValueTag::primitive_int) {
+            register_at(args[0]) = Value {-arg.as_int()};
+        } else if (arg.tag() == ValueTag::primitive_float) {
+            register_at(args[0]) = Value {-arg.as_float()};
+        } else {
+            raise_fault(Errcode::xerr_arithmetic, "Invalid negation on non-numeric Value.");
+            register_at(args[0]) = Value {};
+        }
+    }
+
+    void VM::handle_reg_jump_not_if(const std::array<Codegen::Locator, 3>& args, int next_pos) noexcept {
+        m_iptr = read_register_operand(args[1]).as_bool() ? next_pos : args[0].id;
+    }
+
+    void VM::handle_reg_return(const Codegen::Locator& arg) noexcept {
+        const auto result = read_register_operand(arg);
+        const auto result_slot = current_frame().result_slot;
+
+        m_frames.pop_back();
+        m_values[result_slot] = result;
+
+        if (!is_done()) {
+            m_iptr = current_frame().callee_pos;
+            refresh_active_frame();
+        } else {
+            m_iptr = 0;
+        }
+    }
+
+    void VM::handle_reg_call(const std::array<Codegen::Locator, 3>& args, int ret_pos) noexcept {
+        const auto callee_id = args[0].id;
+        const auto argc = args[1].id;
+        const auto callee_base = m_frame_base + args[2].id;
+
+        if (m_jit) {
+            if (const auto jit_result = try_jit_call(callee_id, m_values.data() + callee_base - argc, argc); jit_result) {
+                m_values[callee_base - argc] = *jit_result;
+                m_iptr = ret_pos;
+                return;
+            }
+        }
+
+        if (!has_room_for_frame(callee_id, callee_base, true)) {
+            return;
+        }
+
+        m_frames.back().callee_pos = ret_pos;
+
+        /// NOTE: the value stack only grows, so frames of equal depth reuse their windows.
+        if (const auto window_end = static_cast<std::size_t>(callee_base + m_register_counts[callee_id]); m_values.size() < window_end) {
+            m_values.resize(window_end);
+        }
+
+        m_values[callee_base] = Value {Codegen::Locator {
+            .region = Codegen::Region::routines,
+            .id = callee_id
+        }};
+
+        m_frames.emplace_back(CallFrame {
+            .code = m_decoded_funcs[callee_id].data(),
+            .constants = m_func_views[callee_id].constants.data(),
+            .callee_id = callee_id,
+            .callee_pos = 0,
+            .callee_frame_base = callee_base,
+            .result_slot = callee_base - argc
+        });
+
+        refresh_active_frame();
+        m_iptr = 0;
+    }
+
+    void VM::handle_reg_tail_call(const std::array<Codegen::Locator, 3>& args) noexcept {
+        auto& frame = m_frames.back();
+        const auto callee_id = args[0].id;
+        const auto argc = args[1].id;
+        const auto args_begin = m_frame_base + args[2].id - argc;
+        const auto callee_base = frame.result_slot + argc;
+
+        if (!has_room_for_frame(callee_id, callee_base, false)) {
+            return;
+        }
+
+        std::copy(m_values.begin() + args_begin, m_values.begin() + args_begin + argc, m_values.begin() + frame.result_slot);
+
+        if (const auto window_end = static_cast<std::size_t>(callee_base + m_register_counts[callee_id]); m_values.size() < window_end) {
+            m_values.resize(window_end);
+        }
+
+        m_values[callee_base] = Value {Codegen::Locator {
+            .region = Codegen::Region::routines,
+            .id = callee_id
+        }};
+
+        frame.code = m_decoded_funcs[callee_id].data();
+        frame.constants = m_func_views[callee_id].constants.data();
+        frame.callee_id = callee_id;
+        frame.callee_pos = 0;
+        frame.callee_frame_base = callee_base;
+
+        refresh_active_frame();
+        m_iptr = 0;
+    }
+
+    void VM::handle_reg_native_call(const std::array<Codegen::Locator, 3>& args) noexcept {
+        const auto native_id = args[0].id;
+        const auto argc = args[1].id;
+        const auto callee_base = args[2].id;
+
+        if (const auto native_status = invoke_native_in_place(native_id, m_frame_base + callee_base - argc, argc); native_status != Errcode::xerr_normal) [[unlikely]] {
+            raise_fault(native_status, "Native function reported an error.");
         }
 
-        m_exit_status = m_native_funcs.at(native_id).invoke(*this, args);
+        const auto result = m_values.back();
+        m_values.pop_back();
 
-        /// NOTE: resume execution after native_call instruction (16B encoded)
-        m_iptr += opcode_stride + (3 * opcode_arg_stride);
+        register_at(Codegen::Locator {
+            .region = Codegen::Region::temp_stack,
+            .id = callee_base - argc
+        }) = result;
     }
 }
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "vm/stacks.hpp"
+#include "vm/xpc.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define XLANG_XPC_MMAP 1
+#else
+#define XLANG_XPC_MMAP 0
+#endif
+
+namespace XLang::VM {
+    static constexpr std::array<RuntimeByte, 4> xpc_magic = {'X', 'P', 'C', '\0'};
+    static constexpr auto xpc_opcode_count = static_cast<std::uint16_t>(Opcode::last);
+    static constexpr std::size_t xpc_word_size = sizeof(std::uint64_t);
+
+    /// @note No frame can be deeper than the default value stack, which also keeps `1 + max_stack_depth` from overflowing wherever frames are sized.
+    static constexpr std::uint32_t xpc_max_stack_depth = StackConfig {}.value_stack_limit;
+
+    [[nodiscard]] static std::size_t align_to_word(std::size_t offset) noexcept {
+        return (offset + xpc_word_size - 1) & ~(xpc_word_size - 1);
+    }
+
+    template <typename Unsigned>
+    static void store_le(std::vector<RuntimeByte>& bytes, std::size_t offset, Unsigned value) noexcept {
+        for (std::size_t byte_idx = 0; byte_idx < sizeof(Unsigned); ++byte_idx) {
+            bytes[offset + byte_idx] = static_cast<RuntimeByte>(value >> (8 * byte_idx));
+        }
+    }
+
+    template <typename Unsigned>
+    [[nodiscard]] static Unsigned load_le(const RuntimeByte* bytes, std::size_t offset) noexcept {
+        Unsigned result = 0;
+
+        for (std::size_t byte_idx = 0; byte_idx < sizeof(Unsigned); ++byte_idx) {
+            result |= static_cast<Unsigned>(static_cast<Unsigned>(bytes[offset + byte_idx]) << (8 * byte_idx));
+        }
+
+        return result;
+    }
+
+    XpcImage::XpcImage() noexcept
+    : m_data {nullptr}, m_size {0}, m_mapped {false}, m_owned_words {}, m_funcs {}, m_entry_func_id {-1} {}
+
+    XpcImage::XpcImage(const char* path)
+    : XpcImage {} {
+        /// NOTE: constants are used in place as `Value` words, which are only laid out like the file on little-endian hosts.
+        if constexpr (std::endian::native != std::endian::little) {
+            throw std::runtime_error {"Loading .xpc images needs a little-endian host."};
+        }
+
+#if XLANG_XPC_MMAP
+        if (const int image_fd = open(path, O_RDONLY); image_fd != -1) {
+            struct stat image_stat {};
+
+            if (fstat(image_fd, &image_stat) == 0 && image_stat.st_size > 0) {
+                const auto image_size = static_cast<std::size_t>(image_stat.st_size);
+
+                if (void* image_mem = mmap(nullptr, image_size, PROT_READ, MAP_PRIVATE, image_fd, 0); image_mem != MAP_FAILED) {
+                    m_data = static_cast<const RuntimeByte*>(image_mem);
+                    m_size = image_size;
+                    m_mapped = true;
+                }
+            }
+
+            close(image_fd);
+        }
+#endif
+
+        if (!m_mapped) {
+            std::ifstream reader {path, std::ios::binary};
+
+            if (!reader) {
+                throw std::runtime_error {"Cannot open .xpc image."};
+            }
+
+            const std::vector<char> raw_bytes {std::istreambuf_iterator<char> {reader}, std::istreambuf_iterator<char> {}};
+
+            m_owned_words.resize(align_to_word(raw_bytes.size()) / xpc_word_size);
+            std::memcpy(m_owned_words.data(), raw_bytes.data(), raw_bytes.size());
+            m_data = reinterpret_cast<const RuntimeByte*>(m_owned_words.data());
+            m_size = raw_bytes.size();
+        }
+
+        try {
+            validate_and_index();
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    XpcImage::~XpcImage() {
+        release();
+    }
+
+    XpcImage::XpcImage(XpcImage&& other) noexcept
+    : m_data {std::exchange(other.m_data, nullptr)}, m_size {std::exchange(other.m_size, 0)}, m_mapped {std::exchange(other.m_mapped, false)}, m_owned_words {std::move(other.m_owned_words)}, m_funcs {std::move(other.m_funcs)}, m_entry_func_id {std::exchange(other.m_entry_func_id, -1)} {}
+
+    XpcImage& XpcImage::operator=(XpcImage&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_mapped = std::exchange(other.m_mapped, false);
+            m_owned_words = std::move(other.m_owned_words);
+            m_funcs = std::move(other.m_funcs);
+            m_entry_func_id = std::exchange(other.m_entry_func_id, -1);
+        }
+
+        return *this;
+    }
+
+    const std::vector<ChunkView>& XpcImage::functions() const noexcept {
+        return m_funcs;
+    }
+
+    int XpcImage::entry_func_id() const noexcept {
+        return m_entry_func_id;
+    }
+
+    void XpcImage::validate_and_index() {
+        if (m_size < XpcFormat::cm_header_size || std::memcmp(m_data, xpc_magic.data(), xpc_magic.size()) != 0) {
+            throw std::runtime_error {"Not an .xpc image."};
+        }
+
+        if (load_le<std::uint16_t>(m_data, 4) != XpcFormat::cm_version) {
+            throw std::runtime_error {"Unsupported .xpc format version."};
+        }
+
+        if (load_le<std::uint16_t>(m_data, 6) != xpc_opcode_count) {
+            throw std::runtime_error {".xpc image was compiled for another opcode set."};
+        }
+
+        const auto funcs_n = static_cast<std::size_t>(load_le<std::uint32_t>(m_data, 8));
+        const auto entry_id = static_cast<int>(load_le<std::uint32_t>(m_data, 12));
+
+        if (load_le<std::uint64_t>(m_data, 16) != m_size || funcs_n > (m_size - XpcFormat::cm_header_size) / XpcFormat::cm_table_entry_size) {
+            throw std::runtime_error {"Truncated .xpc image."};
+        }
+
+        if (entry_id < 0 || static_cast<std::size_t>(entry_id) >= funcs_n) {
+            throw std::runtime_error {"Invalid entry function in .xpc image."};
+        }
+
+        m_funcs.reserve(funcs_n);
+
+        for (std::size_t func_idx = 0; func_idx < funcs_n; ++func_idx) {
+            const auto entry_pos = XpcFormat::cm_header_size + func_idx * XpcFormat::cm_table_entry_size;
+            const std::size_t consts_offset = load_le<std::uint32_t>(m_data, entry_pos);
+            const std::size_t consts_n = load_le<std::uint32_t>(m_data, entry_pos + 4);
+            const std::size_t code_offset = load_le<std::uint32_t>(m_data, entry_pos + 8);
+            const std::size_t code_size = load_le<std::uint32_t>(m_data, entry_pos + 12);
+            const auto max_stack_depth = load_le<std::uint32_t>(m_data, entry_pos + 16);
+
+            if (consts_offset % xpc_word_size != 0 || consts_offset > m_size || consts_n > (m_size - consts_offset) / xpc_word_size || code_offset > m_size || code_size > m_size - code_offset) {
+                throw std::runtime_error {"Function table of .xpc image points outside of it."};
+            }
+
+            if (max_stack_depth > xpc_max_stack_depth) {
+                throw std::runtime_error {"Invalid max stack depth in .xpc image."};
+            }
+
+            const std::span<const Value> constants {reinterpret_cast<const Value*>(m_data + consts_offset), consts_n};
+
+            for (std::size_t const_idx = 0; const_idx < consts_n; ++const_idx) {
+                if (std::bit_cast<Value>(load_le<std::uint64_t>(m_data, consts_offset + const_idx * xpc_word_size)).tag() >= ValueTag::last) {
+                    throw std::runtime_error {"Invalid constant in .xpc image."};
+                }
+            }
+
+            m_funcs.emplace_back(ChunkView {
+                .constants = constants,
+                .bytecode = {m_data + code_offset, code_size},
+                .max_stack_depth = static_cast<int>(max_stack_depth)
+            });
+        }
+
+        m_entry_func_id = entry_id;
+    }
+
+    void XpcImage::release() noexcept {
+#if XLANG_XPC_MMAP
+        if (m_mapped) {
+            munmap(const_cast<RuntimeByte*>(m_data), m_size);
+        }
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+        m_owned_words.clear();
+        m_funcs.clear();
+    }
+
+    void write_xpc(const XpliceProgram& prgm, std::ostream& out) {
+        const auto& funcs = prgm.func_chunks;
+        const auto funcs_n = funcs.size();
+
+        /// NOTE: lay out every function's pools first, so the table can be filled in one pass.
+        std::vector<std::array<std::size_t, 2>> pool_offsets;
+        pool_offsets.reserve(funcs_n);
+
+        auto next_offset = XpcFormat::cm_header_size + funcs_n * XpcFormat::cm_table_entry_size;
+
+        for (const auto& func : funcs) {
+            const auto& chunk = func.view_code();
+            const auto consts_offset = align_to_word(next_offset);
+            const auto code_offset = consts_offset + chunk.constants.size() * xpc_word_size;
+
+            pool_offsets.push_back({consts_offset, code_offset});
+            next_offset = code_offset + chunk.bytecode.size();
+        }
+
+        std::vector<RuntimeByte> image (next_offset, 0);
+
+        std::memcpy(image.data(), xpc_magic.data(), xpc_magic.size());
+        store_le<std::uint16_t>(image, 4, XpcFormat::cm_version);
+        store_le<std::uint16_t>(image, 6, xpc_opcode_count);
+        store_le<std::uint32_t>(image, 8, static_cast<std::uint32_t>(funcs_n));
+        store_le<std::uint32_t>(image, 12, static_cast<std::uint32_t>(prgm.entry_func_id));
+        store_le<std::uint64_t>(image, 16, static_cast<std::uint64_t>(image.size()));
+
+        for (std::size_t func_idx = 0; func_idx < funcs_n; ++func_idx) {
+            const auto& [constants, bytecode, max_stack_depth] = funcs[func_idx].view_code();
+            const auto [consts_offset, code_offset] = pool_offsets[func_idx];
+            const auto entry_pos = XpcFormat::cm_header_size + func_idx * XpcFormat::cm_table_entry_size;
+
+            store_le<std::uint32_t>(image, entry_pos, static_cast<std::uint32_t>(consts_offset));
+            store_le<std::uint32_t>(image, entry_pos + 4, static_cast<std::uint32_t>(constants.size()));
+            store_le<std::uint32_t>(image, entry_pos + 8, static_cast<std::uint32_t>(code_offset));
+            store_le<std::uint32_t>(image, entry_pos + 12, static_cast<std::uint32_t>(bytecode.size()));
+            store_le<std::uint32_t>(image, entry_pos + 16, static_cast<std::uint32_t>(max_stack_depth));
+
+            for (std::size_t const_idx = 0; const_idx < constants.size(); ++const_idx) {
+                store_le<std::uint64_t>(image, consts_offset + const_idx * xpc_word_size, std::bit_cast<std::uint64_t>(constants[const_idx]));
+            }
+
+            std::copy(bytecode.begin(), bytecode.end(), image.begin() + static_cast<std::ptrdiff_t>(code_offset));
+        }
+
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+}
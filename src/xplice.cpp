@@ -1,23 +1,205 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <utility>
+#include <variant>
+#include <vector>
 #include <iostream>
+#include <optional>
 #include <print>
 #include "frontend/files.hpp"
+#include "frontend/lexer.hpp"
 #include "frontend/parser.hpp"
+#include "syntax/node_counter.hpp"
 #include "semantics/analysis.hpp"
 #include "codegen/graph_pass.hpp"
 #include "codegen/emit_pass.hpp"
+#include "codegen/disassembler.hpp"
 #include "vm/chunk.hpp"
+#include "vm/aot.hpp"
+#include "vm/sampler.hpp"
+#include "vm/xpc.hpp"
 #include "vm/vm.hpp"
+#include "build_id.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
 
 using namespace XLang;
 
-[[nodiscard]] VM::XpliceProgram compile_source(const char* path_cstr) {
-    std::string source_str = Frontend::read_file(path_cstr);
-    std::string_view source_sv {source_str};
+constexpr std::string_view xplice_version = "0.4.0";
+
+/// @note Natives registered by `main`, currently just `printInt` at id 0. Loading rejects calls to any other native id.
+constexpr int xplice_native_count = 1;
+
+/// @brief Heap traffic seen by the replaced global `operator new` below. Only counted while `--time-passes` is on.
+struct AllocCounters {
+    std::size_t count;
+    std::size_t bytes;
+};
+
+constinit bool g_count_allocs = false;
+constinit AllocCounters g_alloc_counters {0, 0};
+
+void* operator new(std::size_t size) {
+    if (g_count_allocs) {
+        ++g_alloc_counters.count;
+        g_alloc_counters.bytes += size;
+    }
+
+    for (;;) {
+        if (void* block = std::malloc((size > 0) ? size : 1); block != nullptr) {
+            return block;
+        }
+
+        if (auto new_handler = std::get_new_handler(); new_handler != nullptr) {
+            new_handler();
+        } else {
+            throw std::bad_alloc {};
+        }
+    }
+}
+
+/// NOTE: GCC sees these inlined next to the `new` above and mistakes `free` for a mismatched deallocation.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, [[maybe_unused]] std::size_t size) noexcept {
+    std::free(block);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/// @note Peak resident set size so far, in KiB. Zero on hosts without `getrusage`.
+[[nodiscard]] long peak_rss_kib() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage self_usage {};
+
+    if (getrusage(RUSAGE_SELF, &self_usage) != 0) {
+        return 0;
+    }
+
+#if defined(__APPLE__)
+    return self_usage.ru_maxrss / 1024;
+#else
+    return self_usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/// @brief One compiler phase as measured by `--time-passes`. The RSS figure is how far the peak grew, so phases that fit in already-touched memory show 0.
+struct PassStats {
+    std::string_view name;
+    std::chrono::nanoseconds wall_time;
+    long peak_rss_growth_kib;
+    std::size_t alloc_count;
+    std::size_t alloc_bytes;
+};
+
+struct PassReport {
+    std::vector<PassStats> passes;
+    std::size_t token_count;
+    std::size_t ast_node_count;
+    /// @note IR steps per function id, before any fusion in `EmitCodePass`.
+    std::vector<std::size_t> func_ir_steps;
+};
+
+/// @note Runs one phase, recording it into `report` unless that is null.
+template <typename Pass>
+[[nodiscard]] auto run_timed_pass(PassReport* report, std::string_view pass_name, Pass&& pass) {
+    if (report == nullptr) {
+        return pass();
+    }
+
+    const auto rss_before = peak_rss_kib();
+    const auto allocs_before = g_alloc_counters;
+    const auto time_before = std::chrono::steady_clock::now();
+
+    g_count_allocs = true;
+    auto pass_result = pass();
+    g_count_allocs = false;
+
+    const auto time_after = std::chrono::steady_clock::now();
+
+    report->passes.push_back(PassStats {
+        .name = pass_name,
+        .wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(time_after - time_before),
+        .peak_rss_growth_kib = peak_rss_kib() - rss_before,
+        .alloc_count = g_alloc_counters.count - allocs_before.count,
+        .alloc_bytes = g_alloc_counters.bytes - allocs_before.bytes
+    });
+
+    return pass_result;
+}
+
+void print_pass_report(const PassReport& report, const VM::XpliceProgram& prgm) {
+    std::chrono::nanoseconds total_time {0};
+
+    std::print(std::cerr, "\n--- compiler passes ---\n{:<12}{:>14}{:>14}{:>12}{:>14}\n", "pass", "wall (us)", "peak rss +KiB", "allocs", "alloc bytes");
+
+    for (const auto& [pass_name, wall_time, rss_growth, alloc_count, alloc_bytes] : report.passes) {
+        std::print(std::cerr, "{:<12}{:>14}{:>14}{:>12}{:>14}\n", pass_name, wall_time.count() / 1000, rss_growth, alloc_count, alloc_bytes);
+        total_time += wall_time;
+    }
+
+    std::print(std::cerr, "{:<12}{:>14}\n\ntokens: {}, AST nodes: {}\n\n{:<24}{:>12}{:>16}\n", "total", total_time.count() / 1000, report.token_count, report.ast_node_count, "function", "IR steps", "bytecode bytes");
+
+    for (std::size_t func_id = 0; func_id < prgm.func_chunks.size(); ++func_id) {
+        const auto func_name = (func_id < prgm.debug_funcs.size()) ? std::string_view {prgm.debug_funcs[func_id].name} : std::string_view {"?"};
+        const auto ir_steps = (func_id < report.func_ir_steps.size()) ? report.func_ir_steps[func_id] : 0;
+
+        std::print(std::cerr, "{:<24}{:>12}{:>16}\n", func_name, ir_steps, prgm.func_chunks[func_id].view_code().bytecode.size());
+    }
+}
+
+/// @note With `time_passes`, also lexes the source once on its own for a token count, and prints a `PassReport` to stderr. The `parse` phase still includes the lexing the parser drives.
+[[nodiscard]] VM::XpliceProgram compile_source(const char* path_cstr, std::string_view source_sv, bool time_passes = false) {
+    std::optional<PassReport> pass_report;
+    PassReport* report_p = nullptr;
+
+    if (time_passes) {
+        report_p = &pass_report.emplace();
+
+        report_p->token_count = run_timed_pass(report_p, "lex", [source_sv] {
+            Frontend::Lexer lexer {source_sv};
+            std::size_t token_count = 0;
+
+            while (lexer().tag != Frontend::LexTag::eof) {
+                ++token_count;
+            }
+
+            return token_count;
+        });
+    }
 
     Frontend::Parser parser {source_sv};
 
-    auto [ast, parse_errors] = parser();
+    auto [ast, parse_errors] = run_timed_pass(report_p, "parse", [&parser] {
+        return parser();
+    });
 
     if (!parse_errors.empty()) {
         std::print("Parse errors of file at {}:\n\n", path_cstr);
@@ -29,8 +211,14 @@ using namespace XLang;
         throw std::logic_error {"Compilation failed: parse error(s) found."};
     }
 
+    if (report_p != nullptr) {
+        report_p->ast_node_count = Syntax::NodeCounter {}(ast);
+    }
+
     Semantics::SemanticsPass sema {source_sv};
-    auto [sema_native_hints, sema_errors] = sema(ast);
+    auto [sema_native_hints, sema_errors, sema_operand_hints] = run_timed_pass(report_p, "semantics", [&sema, &ast] {
+        return sema(ast);
+    });
 
     if (!sema_errors.empty()) {
         std::print(std::cerr, "Semantic errors of file '{}':\n", path_cstr);
@@ -42,27 +230,249 @@ using namespace XLang;
         throw std::logic_error {"Compilation failed: semantic error(s) found."};
     }
 
-    Codegen::GraphPass ir_emitter {source_sv, &sema_native_hints};
-    auto [ir_func_constants, ir_func_graphs, ir_main_id] = ir_emitter.process(ast);
+    Codegen::GraphPass ir_emitter {source_sv, &sema_native_hints, &sema_operand_hints};
+    auto [ir_func_constants, ir_func_stack_depths, ir_func_names, ir_func_graphs, ir_main_id] = run_timed_pass(report_p, "ir", [&ir_emitter, &ast] {
+        return ir_emitter.process(ast);
+    });
+
+    if (report_p != nullptr) {
+        for (const auto& func_graph : *ir_func_graphs) {
+            std::size_t step_count = 0;
+
+            for (const auto& flow_node : func_graph.view_nodes()) {
+                if (const auto* flow_unit = std::get_if<Codegen::Unit>(&flow_node); flow_unit != nullptr) {
+                    step_count += flow_unit->steps.size();
+                }
+            }
+
+            report_p->func_ir_steps.push_back(step_count);
+        }
+    }
 
     Codegen::EmitCodePass bytecode_emitter;
-    auto prgm_ptr = bytecode_emitter.process_full_ir(ir_func_constants, *ir_func_graphs, ir_main_id);
+    auto prgm_ptr = run_timed_pass(report_p, "emit", [&] {
+        return bytecode_emitter.process_full_ir(ir_func_constants, ir_func_stack_depths, ir_func_names, *ir_func_graphs, ir_main_id);
+    });
+
+    if (report_p != nullptr) {
+        print_pass_report(*report_p, *prgm_ptr);
+    }
 
     return {std::move(*prgm_ptr)};
 }
 
-[[nodiscard]] VM::Errcode native_print_int(VM::VM* vm_p, const VM::ArgStore& argv) {
-    VM::Value target = argv.at(0);
-    const auto& target_box = target.inner_box();
+/// @note Picks `$XPLICE_CACHE_DIR`, else `$XDG_CACHE_HOME/xplice`, else `$HOME/.cache/xplice`. Empty when caching is off or no location is known.
+[[nodiscard]] std::filesystem::path find_cache_dir() {
+    if (const char* cache_dir_env = std::getenv("XPLICE_CACHE_DIR"); cache_dir_env != nullptr) {
+        return cache_dir_env;
+    }
+
+    if (const char* xdg_cache_env = std::getenv("XDG_CACHE_HOME"); xdg_cache_env != nullptr && *xdg_cache_env != '\0') {
+        return std::filesystem::path {xdg_cache_env} / "xplice";
+    }
+
+    if (const char* home_env = std::getenv("HOME"); home_env != nullptr && *home_env != '\0') {
+        return std::filesystem::path {home_env} / ".cache" / "xplice";
+    }
+
+    return {};
+}
+
+/// @note Content address of a compiled source: FNV-1a over the compiler version, the build id hashed from the compiler sources, the `.xpc` format version, and the source text, plus the source length.
+[[nodiscard]] std::string make_cache_key(std::string_view source_sv) {
+    constexpr std::uint64_t fnv_offset_basis = 14695981039346656037ULL;
+    constexpr std::uint64_t fnv_prime = 1099511628211ULL;
+
+    auto hash = fnv_offset_basis;
+
+    auto hash_bytes = [&hash](std::string_view bytes) noexcept {
+        for (const auto byte : bytes) {
+            hash = (hash ^ static_cast<unsigned char>(byte)) * fnv_prime;
+        }
+    };
+
+    hash_bytes(xplice_version);
+    hash_bytes(xplice_build_id);
+    hash_bytes(std::format("/xpc{}/", VM::XpcFormat::cm_version));
+    hash_bytes(source_sv);
+
+    return std::format("{:016x}-{:x}.xpc", hash, source_sv.size());
+}
+
+/// @note Fills a cache entry by writing a temporary file next to it and renaming it into place, so concurrent runs never see a partial image. Failures only cost the cache entry.
+void fill_cache_entry(const std::filesystem::path& entry_path, const VM::XpliceProgram& program) {
+    std::error_code fs_error;
+    std::filesystem::create_directories(entry_path.parent_path(), fs_error);
+
+    if (fs_error) {
+        return;
+    }
+
+    auto temp_path = entry_path;
+    temp_path += std::format(".{:x}.tmp", std::random_device {}());
+
+    {
+        std::ofstream xpc_out {temp_path, std::ios::binary};
+
+        if (!xpc_out) {
+            return;
+        }
+
+        VM::write_xpc(program, xpc_out);
+
+        if (!xpc_out.flush()) {
+            xpc_out.close();
+            std::filesystem::remove(temp_path, fs_error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temp_path, entry_path, fs_error);
+
+    if (fs_error) {
+        std::filesystem::remove(temp_path, fs_error);
+    }
+}
+
+/**
+ * @brief Runs `.xpc` images from `xplice --compile` straight from their mapping, and compiles anything else as source.
+ * @note Sources go through the compile cache unless `use_cache` is off: a hit runs the cached image without touching the front-end, and a miss compiles then fills the entry. Unreadable or stale entries count as misses.
+ */
+[[nodiscard]] VM::VM load_program(const char* path_cstr, VM::EngineKind engine_kind, bool use_jit, bool use_cache, bool time_passes, VM::StackConfig stack_config) {
+    if (std::string_view path_sv {path_cstr}; path_sv.ends_with(".xpc")) {
+        return VM::VM {VM::XpcImage {path_cstr}, engine_kind, use_jit, stack_config, xplice_native_count};
+    }
+
+    const auto source_str = Frontend::read_file(path_cstr);
+    const auto cache_dir = use_cache ? find_cache_dir() : std::filesystem::path {};
+
+    if (cache_dir.empty()) {
+        return VM::VM {compile_source(path_cstr, source_str, time_passes), engine_kind, use_jit, stack_config, xplice_native_count};
+    }
+
+    const auto entry_path = cache_dir / make_cache_key(source_str);
+
+    try {
+        if (std::error_code fs_error; std::filesystem::exists(entry_path, fs_error)) {
+            return VM::VM {VM::XpcImage {entry_path.string().c_str()}, engine_kind, use_jit, stack_config, xplice_native_count};
+        }
+    } catch (const std::runtime_error&) {
+        /// NOTE: corrupt or outdated entries are simply overwritten below.
+    }
+
+    auto program = compile_source(path_cstr, source_str, time_passes);
+    fill_cache_entry(entry_path, program);
+
+    return VM::VM {std::move(program), engine_kind, use_jit, stack_config, xplice_native_count};
+}
+
+/// @brief Prints the `--profile` tables to stderr: opcodes by total ticks, functions by id, then the most frequent opcode pairs.
+void print_profile_report(const VM::OpcodeProfiler& profiler) {
+    constexpr std::size_t top_bigrams_n = 16;
+    const auto& op_names = Codegen::Disassembler::cm_opcode_names;
+    const auto& op_counts = profiler.op_counts();
+    const auto& op_ticks = profiler.op_ticks();
+    const auto tick_unit = VM::OpcodeProfiler::tick_unit();
+
+    std::vector<std::size_t> op_order;
+
+    for (std::size_t op_id = 0; op_id < op_counts.size(); ++op_id) {
+        if (op_counts[op_id] > 0) {
+            op_order.push_back(op_id);
+        }
+    }
+
+    std::ranges::sort(op_order, [&op_ticks](std::size_t lhs, std::size_t rhs) {
+        return op_ticks[lhs] > op_ticks[rhs];
+    });
+
+    std::print(std::cerr, "\n--- opcode profile ({}) ---\n{:<16}{:>14}{:>18}{:>12}\n", tick_unit, "opcode", "count", "ticks", "avg");
+
+    for (const auto op_id : op_order) {
+        std::print(std::cerr, "{:<16}{:>14}{:>18}{:>12}\n", op_names[op_id], op_counts[op_id], op_ticks[op_id], op_ticks[op_id] / op_counts[op_id]);
+    }
+
+    const auto& func_counts = profiler.func_counts();
+    const auto& func_ticks = profiler.func_ticks();
+
+    std::print(std::cerr, "\n--- function profile ({}) ---\n{:<16}{:>14}{:>18}\n", tick_unit, "function", "count", "ticks");
+
+    for (std::size_t func_id = 0; func_id < func_counts.size(); ++func_id) {
+        if (func_counts[func_id] > 0) {
+            std::print(std::cerr, "{:<16}{:>14}{:>18}\n", func_id, func_counts[func_id], func_ticks[func_id]);
+        }
+    }
+
+    const auto& bigram_counts = profiler.bigram_counts();
+    std::vector<std::size_t> bigram_order;
+
+    for (std::size_t pair_id = 0; pair_id < bigram_counts.size(); ++pair_id) {
+        if (bigram_counts[pair_id] > 0) {
+            bigram_order.push_back(pair_id);
+        }
+    }
+
+    const auto shown_n = std::min(top_bigrams_n, bigram_order.size());
+
+    std::ranges::partial_sort(bigram_order, bigram_order.begin() + static_cast<std::ptrdiff_t>(shown_n), [&bigram_counts](std::size_t lhs, std::size_t rhs) {
+        return bigram_counts[lhs] > bigram_counts[rhs];
+    });
+
+    std::print(std::cerr, "\n--- top opcode pairs ---\n{:<34}{:>14}\n", "pair", "count");
+
+    for (std::size_t rank = 0; rank < shown_n; ++rank) {
+        const auto pair_id = bigram_order[rank];
+        const auto pair_text = std::format("{} -> {}", op_names[pair_id / VM::OpcodeProfiler::cm_opcode_count], op_names[pair_id % VM::OpcodeProfiler::cm_opcode_count]);
+
+        std::print(std::cerr, "{:<34}{:>14}\n", pair_text, bigram_counts[pair_id]);
+    }
+}
+
+/// @brief Writes `--sample` stacks in the collapsed format flamegraph tools read, then prints the source lines with the most samples to stderr.
+[[nodiscard]] bool write_sample_report(const VM::StackSampler& sampler, const VM::VM& engine, const char* output_path) {
+    constexpr std::size_t top_lines_n = 10;
+    const auto stacks = sampler.collapse(engine.debug_info());
+    std::ofstream stacks_out {output_path};
+
+    if (!stacks_out) {
+        std::print(std::cerr, "Cannot write sampled stacks to '{}'\n", output_path);
+        return false;
+    }
+
+    std::map<std::string_view, std::size_t> self_samples;
 
-    if (!std::holds_alternative<int>(target_box)) {
+    for (const auto& [stack_text, sample_n] : stacks) {
+        std::print(stacks_out, "{} {}\n", stack_text, sample_n);
+
+        const auto leaf_begin = stack_text.rfind(';');
+        self_samples[std::string_view {stack_text}.substr((leaf_begin == std::string::npos) ? 0 : leaf_begin + 1)] += sample_n;
+    }
+
+    std::vector<std::pair<std::string_view, std::size_t>> hot_lines {self_samples.begin(), self_samples.end()};
+    const auto shown_n = std::min(top_lines_n, hot_lines.size());
+
+    std::ranges::partial_sort(hot_lines, hot_lines.begin() + static_cast<std::ptrdiff_t>(shown_n), [](const auto& lhs, const auto& rhs) {
+        return lhs.second > rhs.second;
+    });
+
+    std::print(std::cerr, "\n--- sampled lines ({} samples, {} dropped) ---\n", sampler.sample_count(), sampler.dropped_count());
+
+    for (std::size_t rank = 0; rank < shown_n; ++rank) {
+        std::print(std::cerr, "{:<34}{:>10}\n", hot_lines[rank].first, hot_lines[rank].second);
+    }
+
+    return true;
+}
+
+[[nodiscard]] VM::Errcode native_print_int(VM::VM* vm_p, VM::ArgView argv) {
+    if (argv.empty() || argv[0].tag() != VM::ValueTag::primitive_int) {
         vm_p->push_from_native(VM::Value {
             1
         });
         return VM::Errcode::xerr_general;
     }
 
-    std::print("{} ", std::get<int>(target_box));
+    std::print("{} ", argv[0].as_int());
 
     vm_p->push_from_native(VM::Value {
         0
@@ -71,33 +481,146 @@ using namespace XLang;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::print(std::cerr, "usage: xplice [--help | --version | <source-path>]\n");
+    constexpr auto usage_text = "usage: xplice [--help | --version | [--register-vm] [--jit] [--no-cache] [--time-passes] [--profile] [--sample <output-stacks-path>] [--guard-stacks] [--max-stack-values <n>] [--max-call-depth <n>] <source-or-xpc-path> | [--time-passes] --compile <output-xpc-path> <source-path> | [--time-passes] --emit-cpp <output-path> <source-path>]\n";
+
+    if (argc < 2) {
+        std::print(std::cerr, usage_text);
         return 1;
     }
 
     std::string_view process_arg_sv {argv[1]};
+    const char* source_path = argv[argc - 1];
+    auto engine_kind = VM::EngineKind::xek_stack;
+    auto use_jit = false;
+    auto use_cache = true;
+    auto use_profiler = false;
+    auto time_passes = false;
+    VM::StackConfig stack_config;
+    const char* emit_cpp_path = nullptr;
+    const char* compile_xpc_path = nullptr;
+    const char* sample_path = nullptr;
 
     if (process_arg_sv == "--help") {
-        std::print(std::cout, "usage: xplice [--help | --version | <source-path>]\n");
+        std::print(std::cout, usage_text);
         return 0;
     } else if (process_arg_sv == "--version") {
-        std::print(std::cout, "Xplice (runtime) v0.4.0\nContributor Link: github.com/DrkWithT\n");
+        std::print(std::cout, "Xplice (runtime) v{} (build {})\nContributor Link: github.com/DrkWithT\n", xplice_version, xplice_build_id);
+        return 0;
+    }
+
+    for (auto arg_idx = 1; arg_idx < argc - 1; ++arg_idx) {
+        if (std::string_view option_sv {argv[arg_idx]}; option_sv == "--register-vm") {
+            engine_kind = VM::EngineKind::xek_register;
+        } else if (option_sv == "--jit") {
+            use_jit = true;
+        } else if (option_sv == "--no-cache") {
+            use_cache = false;
+        } else if (option_sv == "--time-passes") {
+            time_passes = true;
+        } else if (option_sv == "--profile") {
+            use_profiler = true;
+        } else if (option_sv == "--guard-stacks") {
+            stack_config.guard_pages = true;
+        } else if ((option_sv == "--max-stack-values" || option_sv == "--max-call-depth") && arg_idx + 1 < argc - 1) {
+            auto& limit = (option_sv == "--max-stack-values") ? stack_config.value_stack_limit : stack_config.call_depth_limit;
+            const std::string_view limit_sv {argv[++arg_idx]};
+
+            if (const auto [limit_end, limit_error] = std::from_chars(limit_sv.data(), limit_sv.data() + limit_sv.size(), limit); limit_error != std::errc {} || limit_end != limit_sv.data() + limit_sv.size() || limit < 1) {
+                std::print(std::cerr, usage_text);
+                return 1;
+            }
+        } else if (option_sv == "--sample" && arg_idx + 1 < argc - 1) {
+            sample_path = argv[++arg_idx];
+        } else if (option_sv == "--emit-cpp" && arg_idx + 1 < argc - 1) {
+            emit_cpp_path = argv[++arg_idx];
+        } else if (option_sv == "--compile" && arg_idx + 1 < argc - 1) {
+            compile_xpc_path = argv[++arg_idx];
+        } else {
+            std::print(std::cerr, usage_text);
+            return 1;
+        }
+    }
+
+    if (emit_cpp_path != nullptr) {
+        try {
+            const auto program = compile_source(source_path, Frontend::read_file(source_path));
+            std::ofstream cpp_out {emit_cpp_path};
+
+            if (!cpp_out) {
+                std::print(std::cerr, "Cannot write C++ output to '{}'\n", emit_cpp_path);
+                return 1;
+            }
+
+            VM::emit_cpp_program(program, cpp_out);
+        } catch (const std::logic_error& compile_error) {
+            std::print(std::cerr, "Compile Error:\n{}\n", compile_error.what());
+            return 1;
+        } catch (const std::runtime_error& load_error) {
+            std::print(std::cerr, "Compile Error:\n{}\n", load_error.what());
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (compile_xpc_path != nullptr) {
+        try {
+            const auto program = compile_source(source_path, Frontend::read_file(source_path));
+            std::ofstream xpc_out {compile_xpc_path, std::ios::binary};
+
+            if (!xpc_out) {
+                std::print(std::cerr, "Cannot write .xpc output to '{}'\n", compile_xpc_path);
+                return 1;
+            }
+
+            VM::write_xpc(program, xpc_out);
+        } catch (const std::logic_error& compile_error) {
+            std::print(std::cerr, "Compile Error:\n{}\n", compile_error.what());
+            return 1;
+        }
+
         return 0;
     }
 
     VM::NativeFunction wrap_print_int {native_print_int};
 
     try {
-        /// 1. Initialize VM...
-        VM::VM engine {compile_source(argv[1])};
+        /// 1. Initialize VM... Sampling needs the debug info only a fresh compile has, and timing needs a compile at all, so both skip the cache.
+        auto engine = load_program(source_path, engine_kind, use_jit, use_cache && sample_path == nullptr && !time_passes, time_passes, stack_config);
 
         /// 2. Register a print function for convenience...
         engine.add_native_function(0, wrap_print_int);
 
+        if (use_profiler) {
+            engine.enable_profiling();
+        }
+
+        std::optional<VM::StackSampler> sampler;
+
+        if (sample_path != nullptr) {
+            sampler.emplace(engine);
+            sampler->start();
+        }
+
         auto error_status = engine.run();
 
+        if (sampler) {
+            sampler->stop();
+
+            if (!write_sample_report(*sampler, engine, sample_path)) {
+                return 1;
+            }
+        }
+
+        if (const auto* profiler = engine.profiler(); profiler != nullptr) {
+            print_profile_report(*profiler);
+        }
+
         if (error_status != VM::Errcode::xerr_normal) {
+            if (const auto& fault = engine.fault(); fault.message != nullptr) {
+                std::print(std::cerr, "RuntimeError:\n{}\nAt function {}, instruction {}, call depth {}\n", fault.message, fault.func_id, fault.pc, fault.frame_depth);
+            }
+
             std::print(std::cerr, "Xplice program exited with status code {}\n", static_cast<unsigned int>(error_status));
             return 1;
         }
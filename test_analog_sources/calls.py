@@ -0,0 +1,26 @@
+"""
+    calls.py\n
+    This is a Python 3 replica of the calls benchmark workload for Xplice, and `xplice_bench` times it for comparison.
+"""
+
+def add_three(a: int, b: int, c: int) -> int:
+    return a + b + c
+
+def step(x: int) -> int:
+    return add_three(x, 1, 2) - add_three(x, 0, 2)
+
+def count_steps(n: int) -> int:
+    i = 0
+    acc = 0
+
+    while i < n:
+        acc = acc + step(i)
+        i = i + 1
+
+    return acc
+
+if __name__ == '__main__':
+    if count_steps(200000) == 200000:
+        exit(0)
+    else:
+        exit(1)
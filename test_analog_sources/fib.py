@@ -0,0 +1,16 @@
+"""
+    fib.py\n
+    This is a Python 3 replica of the fib benchmark workload for Xplice, and `xplice_bench` times it for comparison.
+"""
+
+def fib(n: int) -> int:
+    if n < 2:
+        return n
+
+    return fib(n - 1) + fib(n - 2)
+
+if __name__ == '__main__':
+    if fib(27) == 196418:
+        exit(0)
+    else:
+        exit(1)
@@ -0,0 +1,25 @@
+"""
+    floats.py\n
+    This is a Python 3 replica of the floats benchmark workload for Xplice, and `xplice_bench` times it for comparison.
+    NOTE Python floats are doubles while Xplice floats are 32-bit, so only the bounds check matches.
+"""
+
+def integrate(steps: int) -> float:
+    i = 0
+    x = 0.0
+    acc = 0.0
+
+    while i < steps:
+        acc = acc + x * x * 0.00001
+        x = x + 0.00001
+        i = i + 1
+
+    return acc
+
+if __name__ == '__main__':
+    area = integrate(100000)
+
+    if area < 0.32 or area > 0.34:
+        exit(1)
+
+    exit(0)
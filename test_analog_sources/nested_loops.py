@@ -0,0 +1,31 @@
+"""
+    nested_loops.py\n
+    This is a Python 3 replica of the nested_loops benchmark workload for Xplice, and `xplice_bench` times it for comparison.
+    NOTE the inner loop lives in its own function, just like the Xplice version.
+"""
+
+def row_sum(i: int, n: int, total: int) -> int:
+    j = 0
+    acc = total
+
+    while j < n:
+        acc = acc + ((i * j) - int(acc / 7))
+        j = j + 1
+
+    return acc
+
+def grid_sum(n: int) -> int:
+    i = 0
+    total = 0
+
+    while i < n:
+        total = row_sum(i, n, total)
+        i = i + 1
+
+    return total
+
+if __name__ == '__main__':
+    if grid_sum(300) == 613255:
+        exit(0)
+    else:
+        exit(1)
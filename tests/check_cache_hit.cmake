@@ -0,0 +1,28 @@
+# Runs xplice on a source whose compile cache entry an earlier run filled, and fails unless that entry is read without being rewritten...
+# Expects XPLICE, SOURCE, and CACHE_DIR, plus XPLICE_ARGS for any extra flags.
+file(GLOB cache_entries "${CACHE_DIR}/*.xpc")
+list(LENGTH cache_entries cache_entries_n)
+
+if (NOT cache_entries_n EQUAL 1)
+    message(FATAL_ERROR "Expected one compile cache entry in '${CACHE_DIR}', found ${cache_entries_n}.")
+endif ()
+
+file(TIMESTAMP "${cache_entries}" entry_time_before "%s" UTC)
+
+# File times only have whole seconds here, so wait past one: a miss would rename a fresh image over the entry and move its time.
+execute_process(COMMAND "${CMAKE_COMMAND}" -E sleep 1.5)
+execute_process(COMMAND "${XPLICE}" ${XPLICE_ARGS} "${SOURCE}" RESULT_VARIABLE run_status)
+
+if (NOT run_status EQUAL 0)
+    message(FATAL_ERROR "xplice exited with '${run_status}' on the cached run.")
+endif ()
+
+if (NOT EXISTS "${cache_entries}")
+    message(FATAL_ERROR "Compile cache entry '${cache_entries}' is gone after the cached run.")
+endif ()
+
+file(TIMESTAMP "${cache_entries}" entry_time_after "%s" UTC)
+
+if (NOT entry_time_after STREQUAL entry_time_before)
+    message(FATAL_ERROR "Compile cache entry was rewritten, so the run missed the cache.")
+endif ()
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <print>
+#include "vm/aot.hpp"
+
+using namespace XLang;
+
+[[nodiscard]] VM::Errcode native_print_int(VM::VM* vm_p, VM::ArgView argv) {
+    if (argv.empty() || argv[0].tag() != VM::ValueTag::primitive_int) {
+        vm_p->push_from_native(VM::Value {
+            1
+        });
+        return VM::Errcode::xerr_general;
+    }
+
+    std::print("{} ", argv[0].as_int());
+
+    vm_p->push_from_native(VM::Value {
+        0
+    });
+    return VM::Errcode::xerr_normal;
+}
+
+int main() {
+    VM::AotHost host;
+
+    host.add_native_function(0, VM::NativeFunction {native_print_int});
+
+    if (const auto status = VM::run_aot_program(host); status != VM::Errcode::xerr_normal) {
+        if (const auto fault_message = host.fault_message(); fault_message != nullptr) {
+            std::print(std::cerr, "RuntimeError:\n{}\n", fault_message);
+        }
+
+        std::print(std::cerr, "Xplice program exited with status code {}\n", static_cast<unsigned int>(status));
+        return 1;
+    }
+}
@@ -27,7 +27,7 @@ using namespace XLang;
     }
 
     Semantics::SemanticsPass sema {source_view};
-    auto [sema_native_hints, sema_errors] = sema(ast);
+    auto [sema_native_hints, sema_errors, sema_operand_hints] = sema(ast);
 
     if (!sema_errors.empty()) {
         std::print(std::cerr, "Semantic errors in file '{}':\n", file_name);
@@ -40,15 +40,15 @@ using namespace XLang;
     }
 
     Codegen::IRPrinter printer;
-    Codegen::GraphPass gen_graph_pass {source_view, &sema_native_hints};
+    Codegen::GraphPass gen_graph_pass {source_view, &sema_native_hints, &sema_operand_hints};
     auto ir = gen_graph_pass.process(ast);
 
     printer(ir);
 
-    const auto& [constants_storage, cfg_map_sp, main_id] = ir;
+    const auto& [constants_storage, stack_depths, func_names, cfg_map_sp, main_id] = ir;
 
     Codegen::EmitCodePass emitter;
-    auto foo = emitter.process_full_ir(constants_storage, *cfg_map_sp, main_id);
+    auto foo = emitter.process_full_ir(constants_storage, stack_depths, func_names, *cfg_map_sp, main_id);
 
     Codegen::Disassembler disassembler;
     disassembler(*foo);
@@ -0,0 +1,172 @@
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <print>
+#include <string_view>
+#include <vector>
+#include "codegen/disassembler.hpp"
+#include "vm/xpc.hpp"
+
+using namespace XLang;
+
+using ImageBytes = std::vector<unsigned char>;
+
+static void store_u16(ImageBytes& image, std::size_t offset, std::uint16_t value) {
+    image[offset] = static_cast<unsigned char>(value);
+    image[offset + 1] = static_cast<unsigned char>(value >> 8);
+}
+
+static void store_u32(ImageBytes& image, std::size_t offset, std::uint32_t value) {
+    for (std::size_t byte_idx = 0; byte_idx < sizeof(value); ++byte_idx) {
+        image[offset + byte_idx] = static_cast<unsigned char>(value >> (8 * byte_idx));
+    }
+}
+
+[[nodiscard]] static std::uint32_t load_u32(const ImageBytes& image, std::size_t offset) {
+    std::uint32_t result = 0;
+
+    for (std::size_t byte_idx = 0; byte_idx < sizeof(result); ++byte_idx) {
+        result |= static_cast<std::uint32_t>(image[offset + byte_idx]) << (8 * byte_idx);
+    }
+
+    return result;
+}
+
+/// @note Offset of a field in a function's table entry, see `VM::XpcFormat`.
+[[nodiscard]] static constexpr std::size_t entry_field(std::size_t func_idx, std::size_t field_offset) noexcept {
+    return VM::XpcFormat::cm_header_size + func_idx * VM::XpcFormat::cm_table_entry_size + field_offset;
+}
+
+[[nodiscard]] static constexpr std::size_t first_entry_field(std::size_t field_offset) noexcept {
+    return entry_field(0, field_offset);
+}
+
+[[nodiscard]] static std::size_t function_count(const ImageBytes& image) {
+    return load_u32(image, 8);
+}
+
+[[nodiscard]] static constexpr bool is_jump_opcode(VM::Opcode op) noexcept {
+    return op == VM::Opcode::xop_jump || op == VM::Opcode::xop_jump_if || op == VM::Opcode::xop_jump_not_if || (op >= VM::Opcode::xop_jump_not_eq_i32 && op <= VM::Opcode::xop_jump_not_gt_f32);
+}
+
+/// @brief Walks every function's bytecode and points at the first instruction accepted by `matches`, which sees its opcode and image offset.
+/// @return Image offset of that instruction, or 0 when none matched.
+[[nodiscard]] static std::size_t find_instruction(const ImageBytes& image, const std::function<bool(VM::Opcode, std::size_t)>& matches) {
+    for (std::size_t func_idx = 0; func_idx < function_count(image); ++func_idx) {
+        const std::size_t code_begin = load_u32(image, entry_field(func_idx, 8));
+        const auto code_end = code_begin + load_u32(image, entry_field(func_idx, 12));
+
+        for (auto code_pos = code_begin; code_pos < code_end;) {
+            const auto opcode_id = image[code_pos];
+
+            if (matches(static_cast<VM::Opcode>(opcode_id), code_pos)) {
+                return code_pos;
+            }
+
+            code_pos += 1 + 5 * static_cast<std::size_t>(Codegen::Disassembler::cm_opcode_arities.at(opcode_id));
+        }
+    }
+
+    return 0;
+}
+
+/// @note Image offsets of an instruction's Nth operand region byte and id, see `EmitCodePass`.
+[[nodiscard]] static constexpr std::size_t arg_region_at(std::size_t instr_pos, std::size_t arg_num) noexcept {
+    return instr_pos + 1 + 5 * arg_num;
+}
+
+[[nodiscard]] static constexpr std::size_t arg_id_at(std::size_t instr_pos, std::size_t arg_num) noexcept {
+    return arg_region_at(instr_pos, arg_num) + 1;
+}
+
+/// @note Applies one named corruption to a valid image. Returns false for unknown mutations, or when the image has no instruction to corrupt.
+[[nodiscard]] static bool tamper(ImageBytes& image, std::string_view mutation) {
+    if (mutation == "truncate") {
+        /// NOTE: the header still records the full size, so the image is short of it.
+        image.resize(image.size() - 8);
+    } else if (mutation == "bad_magic") {
+        image[0] = 'Y';
+    } else if (mutation == "bad_version") {
+        store_u16(image, 4, VM::XpcFormat::cm_version + 1);
+    } else if (mutation == "table_offset") {
+        store_u32(image, first_entry_field(8), 0xfffffff0U);
+    } else if (mutation == "huge_stack_depth") {
+        store_u32(image, first_entry_field(16), 0x7fffffffU);
+    } else if (mutation == "jump_target") {
+        const auto jump_pos = find_instruction(image, [](VM::Opcode op, [[maybe_unused]] std::size_t pos) {
+            return is_jump_opcode(op);
+        });
+
+        if (jump_pos == 0) {
+            return false;
+        }
+
+        store_u32(image, arg_id_at(jump_pos, 0), 0x00fffff0U);
+    } else if (mutation == "const_id") {
+        const auto const_pos = find_instruction(image, [&image](VM::Opcode op, std::size_t pos) {
+            const auto arity = Codegen::Disassembler::cm_opcode_arities.at(static_cast<std::size_t>(op));
+
+            return arity > 0 && !is_jump_opcode(op) && image[arg_region_at(pos, 0)] == static_cast<unsigned char>(Codegen::Region::consts);
+        });
+
+        if (const_pos == 0) {
+            return false;
+        }
+
+        store_u32(image, arg_id_at(const_pos, 0), 0x00fffff0U);
+    } else if (mutation == "lowered_stack_depth") {
+        for (std::size_t func_idx = 0; func_idx < function_count(image); ++func_idx) {
+            store_u32(image, entry_field(func_idx, 16), 0);
+        }
+    } else if (mutation == "func_id") {
+        const auto call_pos = find_instruction(image, [](VM::Opcode op, [[maybe_unused]] std::size_t pos) {
+            return op == VM::Opcode::xop_call;
+        });
+
+        if (call_pos == 0) {
+            return false;
+        }
+
+        store_u32(image, arg_id_at(call_pos, 0), static_cast<std::uint32_t>(function_count(image) + 7));
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Writes a corrupted copy of an `.xpc` image, so tests can check that loading rejects it instead of crashing.
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::print(std::cerr, "usage: xlang_xpc_tamper <mutation> <input-xpc-path> <output-xpc-path>\n");
+        return 1;
+    }
+
+    std::ifstream image_in {argv[2], std::ios::binary};
+
+    if (!image_in) {
+        std::print(std::cerr, "Cannot read .xpc input '{}'\n", argv[2]);
+        return 1;
+    }
+
+    ImageBytes image {std::istreambuf_iterator<char> {image_in}, std::istreambuf_iterator<char> {}};
+
+    if (image.size() < VM::XpcFormat::cm_header_size + VM::XpcFormat::cm_table_entry_size) {
+        std::print(std::cerr, "Input '{}' is too small to hold a function table.\n", argv[2]);
+        return 1;
+    }
+
+    if (!tamper(image, argv[1])) {
+        std::print(std::cerr, "Cannot apply mutation '{}' to '{}'\n", argv[1], argv[2]);
+        return 1;
+    }
+
+    std::ofstream image_out {argv[3], std::ios::binary};
+
+    if (!image_out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()))) {
+        std::print(std::cerr, "Cannot write .xpc output to '{}'\n", argv[3]);
+        return 1;
+    }
+}